@@ -0,0 +1,19 @@
+#include "ActionBudget.h"
+#include <algorithm>
+
+void ActionBudget::update(int tick, int allowance, bool isCoolingDown)
+{
+    m_allowance     = allowance;
+    m_isCoolingDown = isCoolingDown;
+
+    while (!m_spentTicks.empty() && m_spentTicks.front() <= tick - m_interval)
+        m_spentTicks.pop_front();
+}
+
+int ActionBudget::available() const
+{
+    if (m_isCoolingDown)
+        return 0;
+
+    return std::max(1, m_allowance - spent());   // server says there is a point, so trust it
+}
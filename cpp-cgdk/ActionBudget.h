@@ -0,0 +1,28 @@
+#pragma once
+#include <deque>
+
+// Actions spent within the sliding actionDetectionInterval window. The server allows baseActionCount
+// actions per window plus additionalActionCountPerControlCenter for each owned control center.
+class ActionBudget
+{
+public:
+    ActionBudget() : m_interval(0), m_allowance(0), m_isCoolingDown(false) {}
+
+    void init(int interval)                   { m_interval = interval; }
+
+    // called when a tick starts; server cooldown is the truth if our estimate is behind
+    void update(int tick, int allowance, bool isCoolingDown);
+    void onActionSpent(int tick)              { m_spentTicks.push_back(tick); }
+
+    int  spent() const                        { return static_cast<int>(m_spentTicks.size()); }
+    int  available() const;
+
+    // true if an action may be spent and at least reserve actions are left in the window after it
+    bool canSpend(int reserve = 0) const      { return available() > reserve; }
+
+private:
+    int             m_interval;
+    int             m_allowance;
+    bool            m_isCoolingDown;
+    std::deque<int> m_spentTicks;       // ascending
+};
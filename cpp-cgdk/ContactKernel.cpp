@@ -0,0 +1,168 @@
+#include "ContactKernel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CONTACT_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CONTACT_KERNEL_AVX2     // MSVC allows intrinsics of any instruction set without compiler flags
+#else
+#define CONTACT_KERNEL_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+typedef bool (*ContactFn)(const MovingCircle&, const double*, const double*, const double*, size_t, double&);
+
+// |p + v * t| < r, the earliest root of the quadratic. Infinity when there is no contact
+static inline double pairContactTime(const MovingCircle& circle, double a, double x, double y, double radius)
+{
+    const double px = circle.m_x - x;
+    const double py = circle.m_y - y;
+    const double r  = circle.m_radius + radius;
+    const double c  = px * px + py * py - r * r;
+    const double b  = 2 * (px * circle.m_vx + py * circle.m_vy);
+
+    if (c < 0)
+        return b < 0 ? 0 : std::numeric_limits<double>::infinity();   // overlapping pair is a contact only while closing in
+
+    if (a == 0 || b >= 0)
+        return std::numeric_limits<double>::infinity();   // standing or moving apart
+
+    const double discriminant = b * b - 4 * a * c;
+    if (discriminant <= 0)
+        return std::numeric_limits<double>::infinity();   // passing by
+
+    return (-b - std::sqrt(discriminant)) / (2 * a);
+}
+
+static bool findEarliestContactScalar(const MovingCircle& circle, const double* x, const double* y, const double* radius, size_t count, double& contactTime)
+{
+    const double a = circle.m_vx * circle.m_vx + circle.m_vy * circle.m_vy;
+
+    double earliest = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double t = pairContactTime(circle, a, x[i], y[i], radius[i]);
+        earliest = std::min(earliest, t);
+    }
+
+    if (earliest > 1)
+        return false;
+
+    contactTime = earliest;
+    return true;
+}
+
+#ifdef CONTACT_KERNEL_X86
+
+CONTACT_KERNEL_AVX2
+static bool findEarliestContactAvx2(const MovingCircle& circle, const double* x, const double* y, const double* radius, size_t count, double& contactTime)
+{
+    const double a = circle.m_vx * circle.m_vx + circle.m_vy * circle.m_vy;
+
+    const __m256d cx       = _mm256_set1_pd(circle.m_x);
+    const __m256d cy       = _mm256_set1_pd(circle.m_y);
+    const __m256d cr       = _mm256_set1_pd(circle.m_radius);
+    const __m256d vx       = _mm256_set1_pd(circle.m_vx);
+    const __m256d vy       = _mm256_set1_pd(circle.m_vy);
+    const __m256d twoA     = _mm256_set1_pd(2 * a);
+    const __m256d fourA    = _mm256_set1_pd(4 * a);
+    const __m256d zero     = _mm256_setzero_pd();
+    const __m256d infinity = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+
+    const bool isMoving = a > 0;
+
+    __m256d earliest = infinity;
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d px = _mm256_sub_pd(cx, _mm256_loadu_pd(x + i));
+        const __m256d py = _mm256_sub_pd(cy, _mm256_loadu_pd(y + i));
+        const __m256d r  = _mm256_add_pd(cr, _mm256_loadu_pd(radius + i));
+        const __m256d c  = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(px, px), _mm256_mul_pd(py, py)), _mm256_mul_pd(r, r));
+
+        if (!isMoving)
+            continue;
+
+        const __m256d b    = _mm256_mul_pd(_mm256_set1_pd(2.0), _mm256_add_pd(_mm256_mul_pd(px, vx), _mm256_mul_pd(py, vy)));
+        const __m256d disc = _mm256_sub_pd(_mm256_mul_pd(b, b), _mm256_mul_pd(fourA, c));
+
+        // same cases as in pairContactTime(): overlapping and closing in is a contact at 0, separating is none
+        const __m256d closingIn   = _mm256_cmp_pd(b, zero, _CMP_LT_OQ);
+        const __m256d overlapping = _mm256_cmp_pd(c, zero, _CMP_LT_OQ);
+        const __m256d touching    = _mm256_and_pd(closingIn, overlapping);
+        const __m256d valid       = _mm256_andnot_pd(overlapping, _mm256_and_pd(closingIn, _mm256_cmp_pd(disc, zero, _CMP_GT_OQ)));
+        if (_mm256_movemask_pd(_mm256_or_pd(touching, valid)) == 0)
+            continue;
+
+        const __m256d root = _mm256_sqrt_pd(_mm256_max_pd(disc, zero));
+        const __m256d t    = _mm256_div_pd(_mm256_sub_pd(_mm256_sub_pd(zero, b), root), twoA);
+
+        earliest = _mm256_min_pd(earliest, _mm256_blendv_pd(infinity, t, valid));
+        earliest = _mm256_min_pd(earliest, _mm256_blendv_pd(infinity, zero, touching));
+    }
+
+    double lanes[4];
+    _mm256_storeu_pd(lanes, earliest);
+    double result = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+
+    for (; i < count; ++i)
+    {
+        const double t = pairContactTime(circle, a, x[i], y[i], radius[i]);
+        result = std::min(result, t);
+    }
+
+    if (!(result <= 1))
+        return false;
+
+    contactTime = result;
+    return true;
+}
+
+static bool isAvx2Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    const bool hasAvx     = (info[2] & (1 << 28)) != 0;
+    if (!hasOsxsave || !hasAvx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;   // OS doesn't save YMM registers
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif
+
+// selected once, on first use
+static ContactFn kernel()
+{
+    static const ContactFn s_kernel = []()
+    {
+#ifdef CONTACT_KERNEL_X86
+        if (isAvx2Supported())
+            return &findEarliestContactAvx2;
+#endif
+        return &findEarliestContactScalar;
+    }();
+
+    return s_kernel;
+}
+
+bool findEarliestContact(const MovingCircle& circle, const double* x, const double* y, const double* radius, size_t count, double& contactTime)
+{
+    return kernel()(circle, x, y, radius, count, contactTime);
+}
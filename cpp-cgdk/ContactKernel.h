@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+
+// Circle moving linearly by (m_vx, m_vy) while time goes from 0 to 1
+struct MovingCircle
+{
+    double m_x;
+    double m_y;
+    double m_radius;
+    double m_vx;
+    double m_vy;
+};
+
+// Earliest contact of the moving circle with static circles given as flat arrays.
+// Returns false when there is no contact. Circles overlapping from the start are in contact at 0 if they move
+// closer, and ignored if they move apart or along.
+// AVX2 implementation is chosen at runtime when CPU supports it, scalar one otherwise
+bool findEarliestContact(const MovingCircle& circle, const double* x, const double* y, const double* radius, size_t count, double& contactTime);
@@ -0,0 +1,94 @@
+#include "ControlGroups.h"
+#include <algorithm>
+
+void ControlGroups::init(int maxGroup)
+{
+    m_members.assign(maxGroup + 1, Units());
+    m_lastUsedTick.assign(maxGroup + 1, 0);
+}
+
+void ControlGroups::update(const VehicleStore& store, int tick)
+{
+    m_tick = tick;
+
+    for (Units& members : m_members)
+        members.clear();
+
+    // slots are visited in ascending order, so members come out sorted
+    for (VehicleStore::Slot slot = 0; slot < store.size(); ++slot)
+    {
+        if (!store.isAlive(slot) || !store.isMine(slot))
+            continue;
+
+        for (int number : store.vehicle(slot).getGroups())
+        {
+            if (number >= FIRST_GROUP && number < static_cast<int>(m_members.size()))
+                m_members[number].push_back(slot);
+        }
+    }
+
+    m_candidate.erase(std::remove_if(m_candidate.begin(), m_candidate.end(),
+        [&store](VehicleStore::Slot slot) { return !store.isAlive(slot); }), m_candidate.end());
+}
+
+int ControlGroups::find(const Units& units)
+{
+    if (units.empty())
+        return 0;
+
+    for (int number = FIRST_GROUP; number < static_cast<int>(m_members.size()); ++number)
+    {
+        if (m_members[number] == units)
+        {
+            m_lastUsedTick[number] = m_tick;
+            return number;
+        }
+    }
+
+    return 0;
+}
+
+int ControlGroups::numberForCandidate() const
+{
+    if (m_candidate.empty())
+        return 0;
+
+    int freeNumber = 0;
+    for (int number = FIRST_GROUP; number < static_cast<int>(m_members.size()); ++number)
+    {
+        const Units& members = m_members[number];
+        if (members.empty())
+        {
+            freeNumber = freeNumber ? freeNumber : number;
+            continue;
+        }
+
+        // assign adds to a group, so a number bound before the candidate got reinforcements is just extended
+        if (members.size() < m_candidate.size() && std::includes(m_candidate.begin(), m_candidate.end(), members.begin(), members.end()))
+            return number;
+    }
+
+    return freeNumber;
+}
+
+void ControlGroups::onAssigned(int number)
+{
+    m_members[number] = m_candidate;    // server reports it next tick, until then it's ours
+    m_lastUsedTick[number] = m_tick;
+}
+
+int ControlGroups::findStale() const
+{
+    for (int number = FIRST_GROUP; number < static_cast<int>(m_members.size()); ++number)
+    {
+        if (!m_members[number].empty() && m_tick - m_lastUsedTick[number] > STALE_TICKS)
+            return number;
+    }
+
+    return 0;
+}
+
+void ControlGroups::onDisbanded(int number)
+{
+    m_members[number].clear();
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+#include "VehicleStore.h"
+
+// Server-side unit groups bound to our logical groups. A group number is usable for a logical group
+// only while its members are exactly the group units, so the binding is checked against the membership
+// reported by the server on every lookup, and a number which doesn't match anything for long is disbanded.
+// Numbers are handed out from FIRST_GROUP, the lower ones are reserved by State::GROUP_* constants.
+class ControlGroups
+{
+public:
+    typedef std::vector<VehicleStore::Slot> Units;    // sorted, alive only
+
+    static const int FIRST_GROUP = 3;
+    static const int STALE_TICKS = 600;
+
+    ControlGroups() : m_tick(0) {}
+
+    void init(int maxGroup);
+    bool isInitialized() const               { return !m_members.empty(); }
+
+    // rebuilds membership from the groups of my alive units
+    void update(const VehicleStore& store, int tick);
+
+    // group number with exactly these members or 0, the found binding is kept alive
+    int  find(const Units& units);
+
+    // units just selected as a whole, they may get a number when there is a spare action
+    void setCandidate(Units&& units)          { m_candidate = std::move(units); }
+    const Units& candidate() const            { return m_candidate; }
+
+    // number to assign the candidate to: one whose members are a part of the candidate, or a free one. 0 if none
+    int  numberForCandidate() const;
+    void onAssigned(int number);
+
+    // number which wasn't looked up for STALE_TICKS, 0 if none
+    int  findStale() const;
+    void onDisbanded(int number);
+
+private:
+    int                m_tick;
+    std::vector<Units> m_members;           // by group number
+    std::vector<int>   m_lastUsedTick;      // by group number
+    Units              m_candidate;
+};
@@ -19,9 +19,12 @@ DebugOut::~DebugOut()
 void DebugOut::drawVehicles(const State::VehicleByID& vehicles, const model::Player& me)
 {
 #ifdef VISUALIZER
-    for(const std::pair<State::Id, VehiclePtr>& idVehiclePair : vehicles)
+    for (VehicleStore::Slot slot = 0; slot < vehicles.size(); ++slot)
     {
-        const VehiclePtr& vehicle = idVehiclePair.second;
+        if (!vehicles.isAlive(slot))
+            continue;
+
+        const VehiclePtr vehicle = &vehicles.vehicle(slot);
 
         uint32_t color = 0; 
         switch (vehicle->getType())
@@ -137,7 +137,7 @@ Point DefendCapturers::getProtectionPoint(const ProtectionTarget& protectionInfo
     const VehicleGroup& fighters    = fighterGroup();
 
     Point moveTarget = teammate->m_center;
-    bool isDangerousForDefender = alliens != nullptr && !alliens->m_units.empty() && alliens->m_units.front().lock()->getType() == VehicleType::IFV;
+    bool isDangerousForDefender = alliens != nullptr && !alliens->m_units.empty() && alliens->front().getType() == VehicleType::IFV;
     if (protectionInfo.m_squareDistance > k_far || isDangerousForDefender || alliens == nullptr)
         return moveTarget;
 
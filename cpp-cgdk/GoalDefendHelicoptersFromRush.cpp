@@ -22,8 +22,11 @@ using namespace goals;
 using namespace model;
 
 
-bool DefendHelicoptersFromRush::doAttack(Callback shouldAbort, Callback shouldProceed, const VehicleGroup& attackTarget)
+bool DefendHelicoptersFromRush::doAttack(const VehicleGroup& attackTarget)
 {
+    auto shouldAbort   = [this]() { return abortCheck(); };
+    auto shouldProceed = [this, &attackTarget]() { return isReadyForAttack(fighterGroup(), attackTarget); };
+
     const VehicleGroup& attackWith = fighterGroup();
     if (attackWith.m_units.empty() || attackTarget.m_units.empty())
         return true;   // do nothing if not possible to attach (don't block entire goal)
@@ -73,7 +76,7 @@ bool DefendHelicoptersFromRush::doAttack(Callback shouldAbort, Callback shouldPr
     pushNextStep(shouldAbort, [this] {return hasActionPoint(); }, [this, path]() { state().setMoveAction(path); return true; }, "make attack move");
 
     static const int MIN_TICKS_GAP = 10;
-    VehiclePtr firstUnit = attackWith.m_units.front().lock();
+    VehiclePtr firstUnit = &attackWith.front();
 
     int nTicksGap = std::max(MIN_TICKS_GAP, static_cast<int>(path.length() / firstUnit->getMaxSpeed() / 4));
 
@@ -84,7 +87,7 @@ bool DefendHelicoptersFromRush::doAttack(Callback shouldAbort, Callback shouldPr
         static const int MIN_DANGEROUS_TICKS_GAP = 5;
 
         int enemyTicksGap = std::max(MIN_DANGEROUS_TICKS_GAP, 
-                            static_cast<int>(distance / (firstUnit->getMaxSpeed() + attackTarget.m_units.front().lock()->getMaxSpeed())));
+                            static_cast<int>(distance / (firstUnit->getMaxSpeed() + attackTarget.front().getMaxSpeed())));
 
         nTicksGap = enemyTicksGap;
     }
@@ -94,12 +97,28 @@ bool DefendHelicoptersFromRush::doAttack(Callback shouldAbort, Callback shouldPr
 
     pushBackStep(shouldAbort, smartWaiter, DoNothing(), "wait next attack", StepType::ALLOW_MULTITASK);
     
-    pushBackStep(shouldAbort, shouldProceed, std::bind(&DefendHelicoptersFromRush::doAttack, this, shouldAbort, shouldProceed, std::cref(attackTarget)), 
-        "attack again", StepType::ALLOW_MULTITASK);
+    pushBackStep(shouldAbort, shouldProceed, [this, &attackTarget]() { return doAttack(attackTarget); }, "attack again", StepType::ALLOW_MULTITASK);
 
     return true;
 }
 
+bool DefendHelicoptersFromRush::isReadyForAttack(const VehicleGroup& attackWith, const VehicleGroup& attackTarget)
+{
+    if (attackWith.m_units.empty() || attackTarget.m_units.empty())
+        return true;   // do nothing if not possible to attach (don't block entire goal)
+
+    VehiclePtr firstUnit = &attackWith.front();
+
+    int minCooldownTicks = firstUnit->getRemainingAttackCooldownTicks();
+    for (size_t i = 0; i < attackWith.m_units.size(); ++i)
+        minCooldownTicks = std::min(minCooldownTicks, attackWith.unit(i).getRemainingAttackCooldownTicks());
+
+    static const int PREPARE_TICKS = 10;
+    bool isAboutToBeReady = minCooldownTicks < PREPARE_TICKS;
+
+    return state().hasActionPoint() && isAboutToBeReady;
+}
+
 bool DefendHelicoptersFromRush::abortCheck()
 {
     bool isDone      = false;
@@ -125,10 +144,9 @@ bool DefendHelicoptersFromRush::abortCheck()
 
 DefendHelicoptersFromRush::DefendHelicoptersFromRush(State& state, GoalManager& goalManager)
     : Goal(state, goalManager)
-    , m_helicopterIteration(std::min(state.constants().m_helicoprerRadius, state.game()->getHelicopterSpeed()) / 2)
 {
     auto abortCheckFn     = [this]() { return abortCheck(); };
-    auto hasActionPointFn = [this]() { return this->state().hasActionPoint(); };
+    auto hasActionPointFn = HasActionPoint(state);
 
     auto moveToJoinPoint = [this, hasActionPointFn, abortCheckFn]()
     {
@@ -154,37 +172,14 @@ DefendHelicoptersFromRush::DefendHelicoptersFromRush(State& state, GoalManager&
 
     const auto& fighters = fighterGroup();
 
-    auto isReadyForAttack = [this, hasActionPointFn](const VehicleGroup& attackWith, const VehicleGroup& attackTarget)
-    { 
-        if (attackWith.m_units.empty() || attackTarget.m_units.empty())
-            return true;   // do nothing if not possible to attach (don't block entire goal)
-
-        VehiclePtr firstUnit = attackWith.m_units.front().lock();
-
-        int minCooldownTicks = firstUnit->getRemainingAttackCooldownTicks();
-        for (const VehicleCache& nextUnit : attackWith.m_units)
-            minCooldownTicks = std::min(minCooldownTicks, nextUnit.lock()->getRemainingAttackCooldownTicks());
-
-        static const int PREPARE_TICKS = 10;
-        bool isAboutToBeReady = minCooldownTicks < PREPARE_TICKS;
-
-        return hasActionPointFn() && isAboutToBeReady;
-    };
-
     auto isNear = [](const VehicleGroup& attackWith, const VehicleGroup& attackTarget, double distanceLimit)
     {
         return attackWith.m_center.getDistanceTo(attackTarget.m_rect.m_topLeft) < distanceLimit;
     };
 
-    auto doAttackFighters = [this, abortCheckFn, isReadyForAttack]() 
-    { 
-        const VehicleGroup& attacker = fighterGroup();
-        const VehicleGroup& target   = allienFighters();
-
-        return doAttack(abortCheckFn, std::bind(isReadyForAttack, std::cref(attacker), std::cref(target)), target); 
-    };
+    auto doAttackFighters = [this]() { return doAttack(allienFighters()); };
     
-    auto shouldStartAttack = [&isNear, &isReadyForAttack, this]()
+    auto shouldStartAttack = [isNear, this]()
     {
         const double distanceLimit = this->state().enemyDoesNotHeap() ? 8 * fighterGroup().m_rect.width() : 6 * fighterGroup().m_rect.width();
         return isNear(fighterGroup(), allienFighters(), distanceLimit);
@@ -222,7 +217,7 @@ Point DefendHelicoptersFromRush::getActualIfvCoverPos()
 
 bool DefendHelicoptersFromRush::isPathToIfvFree()
 {
-    return helicopterGroup().isPathFree(getActualIfvCoverPos(), Obstacle(fighterGroup()), m_helicopterIteration);
+    return state().isPathFree(helicopterGroup(), getActualIfvCoverPos(), fighterGroup());
 }
 
 bool DefendHelicoptersFromRush::shiftAircraftAway()
@@ -290,15 +285,15 @@ bool DefendHelicoptersFromRush::shiftAircraftAway()
 
         VehicleGroupGhost fightersGhost = VehicleGroupGhost(fighters, fighter2solution);  // TODO
 
-        return helicopters.isPathFree(ifvCenter, Obstacle(fightersGhost), m_helicopterIteration)
-            && fighters.isPathFree(solution, Obstacle(helicopters), m_helicopterIteration);
+        return state().isPathFree(helicopters, ifvCenter, fightersGhost)
+            && state().isPathFree(fighters, solution, helicopters);
     });
 
     const Point solution = solutionIt != std::end(solutions) ? *solutionIt : *std::rbegin(solutions);
     const Vec2d solutionPath = Vec2d::fromPoint(solution - fighterCenter);
 
     pushNextStep([this]() { return abortCheck(); }, 
-                 [this]() { return state().hasActionPoint(); }, 
+                 HasActionPoint(state()), 
                  [solutionPath, this]() { this->state().setMoveAction(solutionPath); return true; }, "move fighters");
 
     return true;
@@ -316,9 +311,9 @@ bool DefendHelicoptersFromRush::prepareCoverByAircraft()
     bool isMovePossible = false;
 
     auto abortCheckFn     = [this]() { return abortCheck(); };
-    auto hasActionPointFn = [this]() { return state().hasActionPoint(); };
+    auto hasActionPointFn = HasActionPoint(state());
 
-    if (fighters.isPathFree(defendDestination, Obstacle(helicopters), m_helicopterIteration))
+    if (state().isPathFree(fighters, defendDestination, helicopters))
     {
         isMovePossible = true;
 
@@ -340,7 +335,7 @@ bool DefendHelicoptersFromRush::prepareCoverByAircraft()
             {
                 return hasActionPointFn()
                     && fighterGroup().m_center.getDistanceTo(bypassPoint) < 1
-                    && fighterGroup().isPathFree(defendDestination, Obstacle(helicopterGroup()), m_helicopterIteration);
+                    && state().isPathFree(fighterGroup(), defendDestination, helicopterGroup());
             };
 
             // push 2 steps in LIFO order: first stage move and then finalMove
@@ -392,8 +387,8 @@ Point DefendHelicoptersFromRush::getAircraftBypassPoint(const VehicleGroup& figh
         VehicleGroupGhost fightersGhost = VehicleGroupGhost(fighters, dFighters);
 
         return tmpPos.m_x > 0 && tmpPos.m_y > 0
-            && fighters.isPathFree(tmpPos, Obstacle(helicopters), m_helicopterIteration)
-            && fightersGhost.isPathFree(defendDestination, Obstacle(helicopters), m_helicopterIteration);
+            && state().isPathFree(fighters, tmpPos, helicopters)
+            && state().isPathFree(fightersGhost, defendDestination, helicopters);
     });
 
     return solutionIt != std::end(solutions) ? *solutionIt : Point();
@@ -404,11 +399,11 @@ Point DefendHelicoptersFromRush::getFightersTargetPoint(const VehicleGroup& main
     std::vector<Point> attackPoints;
     attackPoints.reserve(mainTarget.m_units.size());
 
-    VehiclePtr myFirstUnit = attackWith.m_units.front().lock();
+    VehiclePtr myFirstUnit = &attackWith.front();
     
     VehicleGroup mergedGroup;
     const double maxDangerousHealth = attackWith.m_healthSum / 2;
-    if (state().isEnemyCoveredByAnother(mainTarget.m_units.front().lock()->getType(), mergedGroup)
+    if (state().isEnemyCoveredByAnother(mainTarget.front().getType(), mergedGroup)
         && mergedGroup.m_healthSum > maxDangerousHealth)
     {
         // enemy is mixed with another group, be careful
@@ -416,22 +411,21 @@ Point DefendHelicoptersFromRush::getFightersTargetPoint(const VehicleGroup& main
         // TODO - add some better anchor like my spawn position, closest unit, etc. 
         const Point& anchor = attackWith.m_center;
         
-        std::vector<Point> enemyFringe;
-        enemyFringe.reserve(mergedGroup.m_units.size());
-
-        std::transform(mergedGroup.m_units.begin(), mergedGroup.m_units.end(), std::back_inserter(enemyFringe), 
-            [](const VehicleCache& cache) { return *cache.lock(); });
+        // merged group consists of whole enemy groups, so the closest unit of merged types is the closest unit of merged group
+        VehicleGrid::Filter mergedTypes = VehicleGrid::Filter::enemy();
+        for (size_t i = 0; i < mergedGroup.m_units.size(); ++i)
+            mergedTypes.add(mergedGroup.unit(i).getType());
 
-        std::sort(enemyFringe.begin(), enemyFringe.end(), 
-            [&anchor](const Point& left, const Point& right) { return anchor.getSquareDistance(left) < anchor.getSquareDistance(right); });
+        const VehicleGrid::Slot closestEnemy = state().vehicleGrid().nearest(anchor, mergedTypes);
+        assert(closestEnemy != VehicleStore::INVALID_SLOT);
 
         double attackersGroupRadius = 1;
-        for (const VehicleCache& cache : attackWith.m_units)
-            attackersGroupRadius = std::max(attackersGroupRadius, attackWith.m_center.getDistanceTo(*cache.lock()));
+        for (size_t i = 0; i < attackWith.m_units.size(); ++i)
+            attackersGroupRadius = std::max(attackersGroupRadius, attackWith.m_center.getDistanceTo(attackWith.unitPoint(i)));
 
         double agressionGap = 4 * myFirstUnit->getRadius();
 
-        Vec2d targetDirection = enemyFringe.front() - attackWith.m_center;
+        Vec2d targetDirection = state().getAllVehicles().point(closestEnemy) - attackWith.m_center;
         double actualDistance = targetDirection.length() - attackersGroupRadius;
         double desiredDistance = state().game()->getFighterAerialAttackRange() - 2 * myFirstUnit->getRadius() - agressionGap;
 
@@ -481,7 +475,7 @@ Point DefendHelicoptersFromRush::getFightersTargetPoint(const VehicleGroup& main
     const VehicleGroup& obstacle = helicopterGroup();
 
     std::stable_partition(std::begin(attackPoints), std::end(attackPoints),
-        [this, &attackWith, &obstacle](const Point& p) { return attackWith.isPathFree(p, Obstacle(obstacle), m_helicopterIteration); });
+        [this, &attackWith, &obstacle](const Point& p) { return state().isPathFree(attackWith, p, obstacle); });
 
     return attackPoints[0];
 }
@@ -18,10 +18,10 @@ namespace goals
         bool abortCheck();
         bool hasActionPoint()               { return state().player()->getRemainingActionCooldownTicks() == 0; }
 
-        const double       m_helicopterIteration;  // size of movement emulation increment
         Point              m_ifvCoverPos;
 
-        bool doAttack(Callback shouldAbort, Callback shouldProceed, const VehicleGroup& attackTarget);
+        bool doAttack(const VehicleGroup& attackTarget);
+        bool isReadyForAttack(const VehicleGroup& attackWith, const VehicleGroup& attackTarget);
 
         bool shiftAircraftAway();
 		bool prepareCoverByAircraft();
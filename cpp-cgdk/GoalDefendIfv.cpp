@@ -1,5 +1,6 @@
 #include "GoalDefendIfv.h"
 #include "model/VehicleType.h"
+#include "goalUtils.h"
 
 using namespace model;
 using namespace goals;
@@ -22,7 +23,7 @@ bool GoalDefendIfv::shiftAircraft()
     const VehicleGroup& fighters    = fighterGroup();
     const VehicleGroup& helicopters = helicopterGroup();
 
-    if (helicopters.isPathFree(ifv.m_center, Obstacle(fighters), m_helicopterIteration))
+    if (state().isPathFree(helicopters, ifv.m_center, fighters))
         return true;   // no need to shift
 
     static const double near = 1.2;
@@ -60,8 +61,8 @@ bool GoalDefendIfv::shiftAircraft()
         Rect  proposedRect = fighters.m_rect + displacement;
 
         return state().isCorrectPosition(proposedRect)
-            && fighters.isPathFree(proposed, Obstacle(helicopters), m_helicopterIteration)
-            && helicopters.isPathFree(ifv.m_center, Obstacle(VehicleGroupGhost(fighters, displacement)), m_helicopterIteration);
+            && state().isPathFree(fighters, proposed, helicopters)
+            && state().isPathFree(helicopters, ifv.m_center, VehicleGroupGhost(fighters, displacement));
     });
 
     std::sort(correctSolutons.begin(), correctSolutons.end(), [&fighters](const Point& left, const Point& right)
@@ -75,7 +76,7 @@ bool GoalDefendIfv::shiftAircraft()
 
         Point bestSolution = correctSolutons.front();
         pushNextStep([this]() { return abortCheck(); },
-            [this]() { return state().hasActionPoint(); },
+            HasActionPoint(state()),
             [this, bestSolution, &fighters]() { state().setMoveAction(bestSolution - fighters.m_center); return true; },
             "fighters: defend tank move");
     }
@@ -91,7 +92,7 @@ bool GoalDefendIfv::moveHelicopters()
     state().setSelectAction(helicopterGroup());
 
     pushNextStep([this]() { return abortCheck(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this]() { state().setMoveAction(ifvGroup().m_center - helicopterGroup().m_center); return true; },
                  "helicopters: defend tank move");
 
@@ -100,23 +101,22 @@ bool GoalDefendIfv::moveHelicopters()
 
 GoalDefendIfv::GoalDefendIfv(State& strategyState, GoalManager& goalManager)
     : Goal(strategyState, goalManager)
-    , m_helicopterIteration(std::min(strategyState.constants().m_helicoprerRadius, strategyState.game()->getHelicopterSpeed()) / 2)
 {
     
     Callback abortCheckFn = [this]() { return abortCheck(); };
-    Callback hasActionPointFn = [this]() { return state().hasActionPoint(); };
-    Callback canMoveHelicopters = [this, abortCheckFn, hasActionPointFn]()
+    HasActionPoint hasActionPointFn(state());
+    Callback canMoveHelicopters = [this]()
     {
         static const int MAX_WAIT_TIME = 500;
 
-        bool isPathFree = helicopterGroup().isPathFree(tankGroup().m_center, Obstacle(fighterGroup()), m_helicopterIteration);
+        bool isPathFree = state().isPathFree(helicopterGroup(), tankGroup().m_center, fighterGroup());
         int ticksWaiting = state().world()->getTickIndex() - std::max(state().lastMoveTick(), m_waitTick);
 
         // #todo - add blocking fighter to the helicopters group in ordert to resolve conflict?
         if(!isPathFree && ticksWaiting > MAX_WAIT_TIME)
         {
             m_waitTick = state().world()->getTickIndex() + MAX_WAIT_TIME;
-            pushFirstStep(abortCheckFn, hasActionPointFn, [this]() { return shiftAircraft(); }, "defend ifv: additional shift aircraft", StepType::ALLOW_MULTITASK);
+            pushFirstStep([this]() { return abortCheck(); }, HasActionPoint(state()), [this]() { return shiftAircraft(); }, "defend ifv: additional shift aircraft", StepType::ALLOW_MULTITASK);
         }
 
         return state().hasActionPoint() && isPathFree;
@@ -95,7 +95,7 @@ bool GoalDefendTank::resolveFightersHelicoptersConflict()
             pushNextStep([this]() { return abortCheck(); }, waitUntilNoCollision, DoNothing(), "dt: wait for fighter collision resolve", StepType::ALLOW_MULTITASK);
 
             pushNextStep([this]() { return abortCheck(); },
-                         [this]() { return state().hasActionPoint(); },
+                         HasActionPoint(state()),
                          [this, fighterSolution]() { state().setMoveAction(fighterSolution); return true; },
                          "dt: resolve collision - move fighters away");
         }
@@ -108,7 +108,7 @@ bool GoalDefendTank::resolveFightersHelicoptersConflict()
             pushNextStep([this]() { return abortCheck(); }, waitUntilNoCollision, DoNothing(), "dt: wait for helicopter collision resolve", StepType::ALLOW_MULTITASK);
 
             pushNextStep([this]() { return abortCheck(); },
-                         [this]() { return state().hasActionPoint(); },
+                         HasActionPoint(state()),
                          [this, helicopterSolution]() { state().setMoveAction(helicopterSolution); return true; },
                          "dt: resolve collision - move helicopters away");
         }
@@ -125,7 +125,7 @@ bool GoalDefendTank::shiftAircraft()
     const VehicleGroup& fighters = fighterGroup();
     const VehicleGroup& helicopters = helicopterGroup();
 
-    if (helicopters.isPathFree(tankGroup().m_center, Obstacle(fighterGroup()), m_helicopterIteration))
+    if (state().isPathFree(helicopters, tankGroup().m_center, fighterGroup()))
         return true;   // no need to shift
 
     static const double near = 1.2;
@@ -166,8 +166,8 @@ bool GoalDefendTank::shiftAircraft()
         Rect  proposedRect = fighters.m_rect + displacement;
 
         return state().isCorrectPosition(proposedRect) 
-            && fighters.isPathFree(proposed, Obstacle(helicopters), m_helicopterIteration)
-            && helicopters.isPathFree(tanks.m_center, Obstacle(VehicleGroupGhost(fighters, displacement)), m_helicopterIteration);
+            && state().isPathFree(fighters, proposed, helicopters)
+            && state().isPathFree(helicopters, tanks.m_center, VehicleGroupGhost(fighters, displacement));
     });
 
     // sort by distance to tank (less priority) then by distance to enemy helicopters, then by distance to fighters (most priority)
@@ -192,7 +192,7 @@ bool GoalDefendTank::shiftAircraft()
 
         Point bestSolution = correctSolutons.front();
         pushNextStep([this]() { return abortCheck(); }, 
-                     [this]() { return state().hasActionPoint(); },
+                     HasActionPoint(state()),
                      [this, bestSolution, &fighters]() { state().setMoveAction(bestSolution - fighters.m_center); return true; },
                      "fighters: defend tank move");
     }  
@@ -207,7 +207,7 @@ bool GoalDefendTank::moveHelicopters()
     state().setSelectAction(helicopterGroup());
     
     pushNextStep([this]() { return abortCheck(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this]() { state().setMoveAction(tankGroup().m_center - helicopterGroup().m_center); return true; },
                  "helicopters: defend tank move");
 
@@ -219,7 +219,7 @@ bool GoalDefendTank::startFightersAttack()
     if (fighterGroup().m_center.getDistanceTo(allienHelicopters().m_center) <= m_maxAgressiveDistance)
     {
         pushNextStep([this]() { return abortCheck(); },
-                     [this]() { return state().hasActionPoint(); },
+                     HasActionPoint(state()),
                      [this]() { return loopFithersAttack(); },
                      "fighters: defend tank - attack enemy");
     }
@@ -268,7 +268,7 @@ bool GoalDefendTank::loopFithersAttack()
         {
             Rect proposedRect = fighters.m_rect + (p - fighters.m_center);
             return !helicopters.m_rect.overlaps(proposedRect) 
-                && fighters.isPathFree(p, Obstacle(helicopters), m_helicopterIteration);
+                && state().isPathFree(fighters, p, helicopters);
         });
 
         if (solutionIt != std::end(attackPoints) && !(targetPoint == *solutionIt))
@@ -282,7 +282,7 @@ bool GoalDefendTank::loopFithersAttack()
     const int WAIT_AMOINT = 10;
 
     pushNextStep([this]() { return abortCheck(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this]() { return loopFithersAttack(); },
                  "fighters: defend tank - loop attack enemy");
 
@@ -290,12 +290,12 @@ bool GoalDefendTank::loopFithersAttack()
                  "fighters: defend tank - wait for next iteration", StepType::ALLOW_MULTITASK);
 
     pushNextStep([this]() { return abortCheck(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this, movement]() { state().setMoveAction(movement); return true; },
                  "fighters: defend tank - attack move");
 
     pushNextStep([this]() { return abortCheck(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this, &fighters]() { state().setSelectAction(fighters); return true; },
                  "fighters: defend tank - select fighters");
 
@@ -306,16 +306,15 @@ bool GoalDefendTank::loopFithersAttack()
 
 GoalDefendTank::GoalDefendTank(State& strategyState, GoalManager& goalManager)
     : Goal(strategyState, goalManager)
-    , m_helicopterIteration(std::min(strategyState.constants().m_helicoprerRadius, strategyState.game()->getHelicopterSpeed()) / 2)
     , m_maxAgressiveDistance(strategyState.world()->getWidth() / 4)   // slightly less than half of path from center to me
 {
-    Callback abortCheckFn       = [this]() { return abortCheck(); };
-    Callback hasActionPointFn   = [this]() { return state().hasActionPoint(); };
-    Callback canMoveHelicopters = [this]() 
+    Callback       abortCheckFn       = [this]() { return abortCheck(); };
+    HasActionPoint hasActionPointFn(state());
+    Callback       canMoveHelicopters = [this]() 
     { 
         int conflictTicksLeft = m_lastConflictTick == 0 ? -1 : std::max(0, state().world()->getTickIndex() - m_lastConflictTick - MAX_RESOLVE_CONFLICT_TICKS);
 
-        bool isPathFree = helicopterGroup().isPathFree(tankGroup().m_center, Obstacle(fighterGroup()), m_helicopterIteration);
+        bool isPathFree = state().isPathFree(helicopterGroup(), tankGroup().m_center, fighterGroup());
 
         return state().hasActionPoint() && (isPathFree || conflictTicksLeft == 0);
     };
@@ -324,9 +323,9 @@ GoalDefendTank::GoalDefendTank(State& strategyState, GoalManager& goalManager)
     pushBackStep(abortCheckFn, hasActionPointFn,   [this]() { return shiftAircraft(); }, "defend tank: shift aircraft");
     pushBackStep(abortCheckFn, canMoveHelicopters, [this]() { return moveHelicopters(); }, "defend tank: move helicopters", StepType::ALLOW_MULTITASK);
 
-    auto shouldStart = [this, hasActionPointFn]() 
+    auto shouldStart = [this]() 
     { 
-        return hasActionPointFn && fighterGroup().m_center.getDistanceTo(allienHelicopters().m_center) <= m_maxAgressiveDistance; 
+        return state().hasActionPoint() && fighterGroup().m_center.getDistanceTo(allienHelicopters().m_center) <= m_maxAgressiveDistance; 
     };
 
     pushBackStep(abortCheckFn, shouldStart,   [this]() { return startFightersAttack(); }, "defend tank: attack helicopters", StepType::ALLOW_MULTITASK);
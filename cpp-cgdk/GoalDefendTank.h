@@ -13,7 +13,6 @@ namespace goals
         const double MIN_HEALTH_FACTOR = 0.03;
 
 
-        const double m_helicopterIteration;  // size of movement emulation increment
         const double m_maxAgressiveDistance;
         int          m_lastConflictTick = 0;
         int          m_lastAttackTick   = 0;
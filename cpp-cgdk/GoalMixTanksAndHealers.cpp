@@ -24,7 +24,6 @@ namespace
 
 MixTanksAndHealers::MixTanksAndHealers(State& worldState, GoalManager& goalManager)
     : Goal(worldState, goalManager)
-    , m_iterationSize( std::min( {worldState.game()->getArrvSpeed(), worldState.game()->getTankSpeed(), worldState.game()->getIfvSpeed()} ) / 2.0 )
 {
     initGridPositions();
 
@@ -33,20 +32,13 @@ MixTanksAndHealers::MixTanksAndHealers(State& worldState, GoalManager& goalManag
 
     getGroundUnitOrder(actualPositions, desiredPositions);
 
-    MovePlan movesByType;
+    // each group plans around current positions of others and around waypoints already planned for them
     for (VehicleType type : s_groundUnits)
-        movesByType[type] = getMoves(type, state().teammates(type).m_center, actualPositions[type], desiredPositions[type], true);
+        m_overallMoves[type] = getMoves(type, actualPositions[type], desiredPositions[type]);
 
-    m_overallMoves = m_pendingMoves = movesByType;
+    m_pendingMoves = m_overallMoves;
 
-    // moves can contain collisions, this will resolve them
-    for (VehicleType type : s_groundUnits)
-        movesByType[type] = getMoves(type, state().teammates(type).m_center, actualPositions[type], desiredPositions[type], true);
-
-    m_pendingMoves.swap(movesByType);
-    m_overallMoves = m_pendingMoves;
-
-    // TODO !!! there is an issue on seed #1623792313246972 - can't find a path, aborting
+    // a path may still not exist, e.g. when destination is occupied - aborting then
     bool areMovesInitialized = !m_overallMoves[VehicleType::IFV].empty() && !m_overallMoves[VehicleType::TANK].empty() && !m_overallMoves[VehicleType::ARRV].empty();
 
 //    assert(areMovesInitialized);
@@ -121,14 +113,9 @@ void MixTanksAndHealers::getGroundUnitOrder(PosByType& actualPositions, PosByTyp
     }
 }
 
-MixTanksAndHealers::Destinations MixTanksAndHealers::getMoves(
-    VehicleType groupType, const Point& actualCenter, const GridPos& actual, const GridPos& destination, bool allowShifting)
+MixTanksAndHealers::Destinations MixTanksAndHealers::getMoves(VehicleType groupType, const GridPos& actual, const GridPos& destination)
 {
-    const VehicleGroup& initialGroup = state().teammates(groupType);
-    VehicleGroupGhost ghost = VehicleGroupGhost(initialGroup, actualCenter - initialGroup.m_center);
-
-    const int dx = destination.m_x - actual.m_x;
-    const int dy = destination.m_y - actual.m_y;
+    const VehicleGroup& group = state().teammates(groupType);
     Point to = posToPoint(destination);
 
     if (actual == destination)
@@ -137,30 +124,28 @@ MixTanksAndHealers::Destinations MixTanksAndHealers::getMoves(
     std::vector<const VehicleGroup*> obstacles;
 
     for (VehicleType type : s_groundUnits)
-        if (type != groupType)
+        if (type != groupType && !state().teammates(type).m_units.empty())
             obstacles.push_back(&state().teammates(type));
 
     bool isStraightWay = true;
+    std::vector<Rect> obstacleRects;
+
     for (const VehicleGroup* obstacle : obstacles)
     {
-        if (!isStraightWay)
-            break;
+        obstacleRects.push_back(obstacle->m_rect);
 
-        if (obstacle->m_units.empty())
-            continue;
-
-        if (!ghost.isPathFree(to, Obstacle(*obstacle), m_iterationSize))
+        if (isStraightWay && !state().isPathFree(group, to, *obstacle))
             isStraightWay = false;
 
-        auto obstacleDestinations = m_overallMoves[obstacle->m_units.front().lock()->getType()];
+        const auto& obstacleDestinations = m_overallMoves[obstacle->front().getType()];
         for (const Point& nextPoint : obstacleDestinations)
         {
-            if (!isStraightWay)
-                break;
-
             VehicleGroupGhost obstacleDestination{ *obstacle, nextPoint - obstacle->m_center };   // todo: more careful collision detection and resolve for simultaneous moves
-            if (obstacleDestination.m_center != obstacleDestination.m_original.m_center)
-                isStraightWay = isStraightWay && ghost.isPathFree(to, Obstacle(obstacleDestination), m_iterationSize);
+            if (obstacleDestination.m_center == obstacle->m_center)
+                continue;
+
+            obstacleRects.push_back(obstacleDestination.m_rect);
+            isStraightWay = isStraightWay && state().isPathFree(group, to, obstacleDestination);
         }
     }
 
@@ -169,96 +154,11 @@ MixTanksAndHealers::Destinations MixTanksAndHealers::getMoves(
 
     // find a path through obstacles
 
-    Destinations path;
-    if (dx != 0 && dy != 0)
-    {
-        // move by X, then move by Y
-        const GridPos firstStage       = GridPos(actual.m_x + dx, actual.m_y);
-        const Point   firstStageResult = posToPoint(firstStage);
-
-        Destinations xPart = getMoves(groupType, ghost.m_center, actual, firstStage, false);
-        Destinations yPart = getMoves(groupType, firstStageResult, firstStage, destination, false);
-
-        if (!xPart.empty() && !yPart.empty())
-        {
-            path.insert(path.end(), xPart.begin(), xPart.end());
-            path.insert(path.end(), yPart.begin(), yPart.end());
-        }
-
-        // try alt path: by Y and then by  X
-        const GridPos altStage       = GridPos(actual.m_x, actual.m_y + dy);
-        const Point   altStageResult = posToPoint(altStage);
-
-        Destinations xPartAlt = getMoves(groupType, ghost.m_center, actual, altStage, false);
-        Destinations yPartAlt = getMoves(groupType, altStageResult, altStage, destination, false);
-
-        Destinations altPath;
-        if (!xPartAlt.empty() && !yPartAlt.empty())
-        {
-            altPath.insert(altPath.end(), xPartAlt.begin(), xPartAlt.end());
-            altPath.insert(altPath.end(), yPartAlt.begin(), yPartAlt.end());
-        }
-
-        // choose shorter alternative
-        double primaryLength = path.empty()    ? std::numeric_limits<double>::max() : getPathLength(ghost.m_center, path);
-        double altLength     = altPath.empty() ? std::numeric_limits<double>::max() : getPathLength(ghost.m_center, altPath);
-
-        if (altLength < primaryLength)
-            std::swap(altPath, path);
-    }
-    else if (dy != 0 && allowShifting)
-    {
-        assert(dx == 0);  // this code is for vertical move
-
-        bool shiftLeft = actual.m_x > 0 && (actual.m_y % 2 == 1);    // alternating shift direction in order to avoid repeating collisions
-        const int newDx = shiftLeft ? -1 : 1;
-
-        const GridPos firstStage = GridPos(actual.m_x + newDx, actual.m_y);
-        const Point   firstStageResult = posToPoint(firstStage);
-
-        Destinations xPart = getMoves(groupType, actualCenter, actual, firstStage, false);
-        Destinations yPart = getMoves(groupType, firstStageResult, firstStage, destination, false);
-
-        if (!xPart.empty() && !yPart.empty())
-        {
-            path.insert(path.end(), xPart.begin(), xPart.end());
-            path.insert(path.end(), yPart.begin(), yPart.end());
-        }
-    }
-    else if (dx != 0 && allowShifting)
-    {
-        assert(dy == 0);  // this code is for horizontal move
-
-        bool shiftUp = actual.m_y > 0 && (actual.m_x % 2 == 1);    // alternating shift direction in order to avoid repeating collisions
-        const int newDy = shiftUp ? -1 : 1;
-
-        const GridPos firstStage = GridPos(actual.m_x, actual.m_y + newDy);
-        const Point   firstStageResult = posToPoint(firstStage);
-
-        Destinations xPart = getMoves(groupType, actualCenter, actual, firstStage, false);
-        Destinations yPart = getMoves(groupType, firstStageResult, firstStage, destination, false);
-
-        if (!xPart.empty() && !yPart.empty())
-        {
-            path.insert(path.end(), xPart.begin(), xPart.end());
-            path.insert(path.end(), yPart.begin(), yPart.end());
-        }
-    }
-
-    return path;
-}
-
-double MixTanksAndHealers::getPathLength(const Point& start, const Destinations& path)
-{
-    double length = 0;
-    Point current = start;
-    for (const Point& next : path)
-    {
-        length += current.getDistanceTo(next);
-        current = next;
-    }
+    std::vector<Point> path;
+    if (!state().findGroupPath(groupType, group.m_rect, to, obstacleRects, path))
+        return Destinations();
 
-    return length;
+    return Destinations(path.begin(), path.end());
 }
 
 Point MixTanksAndHealers::posToPoint(const GridPos& pos)
@@ -339,7 +239,7 @@ MixTanksAndHealers::GridPos MixTanksAndHealers::pointToPos(const Point& center)
 
 bool MixTanksAndHealers::applyMovePlan()
 {
-    auto hasActionPoint = [this]() { return state().hasActionPoint(); };
+    auto hasActionPoint = HasActionPoint(state());
 
     for (auto it = m_pendingMoves.begin(); it != m_pendingMoves.end(); )
     {
@@ -389,7 +289,7 @@ bool MixTanksAndHealers::applyMovePlan()
 
 bool MixTanksAndHealers::scaleGroups()
 {
-    auto hasActionPoint = [this]() { return state().hasActionPoint(); };
+    auto hasActionPoint = HasActionPoint(state());
 
     auto getScaleFn = [this, hasActionPoint](VehicleType type, double factor, Point displacement) 
     {
@@ -415,8 +315,8 @@ bool MixTanksAndHealers::scaleGroups()
 
     // reverse iteration due to LIFO pushing order
     double xDisplacement     = leftDisplacementForCell * typesCount;
-    double yArrvDisplacement = 11 /* TODO: it's a kind of magic? */ * tankGroup().m_units.front().lock()->getRadius();
-    double yIfvDesplacement  = 7 * tankGroup().m_units.front().lock()->getRadius();
+    double yArrvDisplacement = 11 /* TODO: it's a kind of magic? */ * tankGroup().front().getRadius();
+    double yIfvDesplacement  = 7 * tankGroup().front().getRadius();
     const double scaleFactor = 1.7;
     for (auto itType = std::rbegin(groupsLeftToRight); itType != std::rend(groupsLeftToRight); ++itType)
     {
@@ -439,7 +339,7 @@ bool MixTanksAndHealers::mixGroups()
 
     state().setSelectAction(arrvGroup());
 
-    auto hasActionPoint = [this]() { return state().hasActionPoint(); };
+    auto hasActionPoint = HasActionPoint(state());
 
     static const int k_rowsCount = 10;
 
@@ -483,10 +383,10 @@ bool MixTanksAndHealers::mixGroups()
 
 void MixTanksAndHealers::setupGoalSteps()
 {
-    auto hasActionPoint = [this]() { return state().hasActionPoint(); };
+    auto hasActionPoint = HasActionPoint(state());
     pushBackStep(NeverAbort(), hasActionPoint, [this]() { return applyMovePlan(); }, "applying move plan");
 
-    // TODO !!! there is an issue on seed #1623792313246972 - can't find a path, aborting
+    // a path may still not exist, e.g. when destination is occupied - aborting then
     assert(!m_overallMoves[VehicleType::IFV].empty() && !m_overallMoves[VehicleType::TANK].empty() && !m_overallMoves[VehicleType::ARRV].empty());
 
     const auto& ifvPlan = m_overallMoves[VehicleType::IFV];
@@ -527,7 +427,7 @@ Point MixTanksAndHealers::getFinalDestination(VehicleType type) const
 
 bool MixTanksAndHealers::revertScale()
 {
-    auto hasActionPoint = [this]() { return state().hasActionPoint(); };
+    auto hasActionPoint = HasActionPoint(state());
 
     auto getScaleFn = [this, hasActionPoint](VehicleType type, double factor)
     {
@@ -55,7 +55,6 @@ namespace goals
 
         static const model::VehicleType s_groundUnits[];
 
-        double m_iterationSize;
 		Point m_topLeftMargin;
 		Point m_gridCellSize;
         MovePlan m_overallMoves;
@@ -64,8 +63,7 @@ namespace goals
 		std::map<int, double> m_xGridToPos;   // convert column number to world position
 		std::map<int, double> m_yGridToPos;   // convert row number to world position
 
-        Destinations getMoves(model::VehicleType groupType, const Point& actualCenter, const GridPos& actual, const GridPos& destination, bool allowShifting);
-        static double getPathLength(const Point& start, const Destinations& path);
+        Destinations getMoves(model::VehicleType groupType, const GridPos& actual, const GridPos& destination);
 
 		void  initGridPositions();
 
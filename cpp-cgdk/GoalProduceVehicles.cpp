@@ -2,6 +2,7 @@
 #include "noReleaseAssert.h"
 #include "goalUtils.h"
 #include <numeric>
+#include <list>
 
 using namespace goals;
 using namespace model;
@@ -80,14 +81,10 @@ const model::Facility* ProduceVehicles::getNearestFacility() const
 bool ProduceVehicles::mergeToGroup()
 {
     // TODO: use group handles
-    if (m_currentPortion.empty())
-        m_currentPortion = state().popNewUnits();
+    const State::GroupByType& currentPortion = state().mergingUnits().empty() ? state().popNewUnits() : state().mergingUnits();
 
     Rect vehiclesRect;
-    for (auto& idGroupPair : m_currentPortion)
-        idGroupPair.second.update();
-
-    State::updateGroupsRect(m_currentPortion, vehiclesRect);
+    State::updateGroupsRect(currentPortion, vehiclesRect);
 
     state().setSelectAction(vehiclesRect);
 
@@ -118,13 +115,7 @@ bool ProduceVehicles::mergeToGroup()
 
     if (shouldMergeNow)
     {
-        for (std::pair<GroupHandle, VehicleGroup> idGroupPair : m_currentPortion)
-        {
-            idGroupPair.first = GroupHandle::initial(idGroupPair.first.vehicleType());   // merge to initial group
-            state().mergeNewUnits(idGroupPair);
-        }
-
-        m_currentPortion.clear();
+        state().mergeNewUnits();
 
         // LIFO pushing order
 
@@ -162,9 +153,9 @@ bool ProduceVehicles::mergeToGroup()
 double ProduceVehicles::getMaxSpeed() const
 {
     double maxSpeed = 0.001;
-    for (const auto& idVehiclePair : m_currentPortion)
+    for (const auto& idVehiclePair : state().mergingUnits())
         if (!idVehiclePair.second.m_units.empty())
-            maxSpeed = std::max(maxSpeed, idVehiclePair.second.m_units.front().lock()->getMaxSpeed());
+            maxSpeed = std::max(maxSpeed, idVehiclePair.second.front().getMaxSpeed());
 
     return maxSpeed;
 }
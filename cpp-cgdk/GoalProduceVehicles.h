@@ -24,9 +24,6 @@ namespace goals
         const VehicleGroup& getGroupToMergeTo() const;
         double getMaxSpeed() const;
 
-
-        State::GroupByType m_currentPortion;
-
 		// actions
 
 		bool startProduction();
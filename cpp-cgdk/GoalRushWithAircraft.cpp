@@ -17,7 +17,7 @@ RushWithAircraft::RushWithAircraft(State& worldState, GoalManager& goalManager)
     // TODO - resolve collision with helicopters before start
 
     pushBackStep([this]() { return shouldAbort(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this]() { return doNextFightersMove(); },
                  "rush air: first fighters step",
                  StepType::ALLOW_MULTITASK);
@@ -41,45 +41,29 @@ bool RushWithAircraft::doNextFightersMove()
 
     TargetInfo bestTargetInfo = getFightersTargetInfo();
 
-    struct Nearest
-    {
-        Point  m_position = Point();
-        double m_squareDistance = std::numeric_limits<double>::max();
-
-        void apply(const Point& candidate, double candidateSqDistance)
-        {
-            if (candidateSqDistance < m_squareDistance)
-            {
-                m_position = candidate;
-                m_squareDistance = candidateSqDistance;
-            }
-        }
-    };
-
-    Nearest target;
+    Point target;
 
-    VehiclePtr firstEnemy;
+    VehiclePtr firstEnemy = nullptr;
     if (state().game()->isFogOfWarEnabled() && bestTargetInfo.isEliminated())
     {
         // target may be not visible due to fog of var, in this case assume it's in bottom right corner
-        target.m_position = Point(state().game()->getWorldWidth(), state().game()->getWorldHeight()) - Point(fighters.m_rect.width(), fighters.m_rect.height());
-        target.m_squareDistance = target.m_position.getSquareDistance(fighters.m_center);
+        target = Point(state().game()->getWorldWidth(), state().game()->getWorldHeight()) - Point(fighters.m_rect.width(), fighters.m_rect.height());
     }
     else
     {
-        firstEnemy = bestTargetInfo.m_group->m_units.empty() ? VehiclePtr() : bestTargetInfo.m_group->m_units.front().lock();
+        firstEnemy = bestTargetInfo.m_group->m_units.empty() ? VehiclePtr() : &bestTargetInfo.m_group->front();
         if (bestTargetInfo.isEliminated() || !firstEnemy)
             return true;  // nothing to attack
 
-        std::for_each(bestTargetInfo.m_group->m_units.begin(), bestTargetInfo.m_group->m_units.end(),
-            [&target, &fighters](const VehicleCache& unitCache)
-        {
-            VehiclePtr unit = unitCache.lock();
-            target.apply(*unit, fighters.m_center.getSquareDistance(*unit));
-        });
+        // nearest unit of the target group, not just any enemy of its type
+        const VehicleGrid::Slot nearestSlot = state().vehicleGrid().nearest(fighters.m_center, VehicleGrid::Filter::memberOf(*bestTargetInfo.m_group));
+        if (nearestSlot == VehicleStore::INVALID_SLOT)
+            return true;
+
+        target = state().getAllVehicles().point(nearestSlot);
     }
 
-    const VehiclePtr firstFighter = fighters.m_units.front().lock();
+    const VehiclePtr firstFighter = &fighters.front();
 
     static const double k_minDanger = 0.01;
 
@@ -95,8 +79,8 @@ bool RushWithAircraft::doNextFightersMove()
         desiredDistance = far;   // force far distance, because fighter can't attack them. TODO: maybe, overlap with enemy between nuke attacks?
     }
 
-    Vec2d reverseDirection = Vec2d(fighters.m_center - target.m_position).truncate(desiredDistance);
-    Point attackPosition   = target.m_position + reverseDirection;
+    Vec2d reverseDirection = Vec2d(fighters.m_center - target).truncate(desiredDistance);
+    Point attackPosition   = target + reverseDirection;
     Vec2d moveVector       = attackPosition - fighters.m_center;    // TODO - unit-perfect aim
 
     bool isMoveAllowed = validateMoveVector(moveVector);  // don't retreat in case of guiding nuclear launch
@@ -111,7 +95,7 @@ bool RushWithAircraft::doNextFightersMove()
     // move to attack point, wait some ticks and repeat
 
     pushNextStep([this]() { return shouldAbort(); },
-                 [this]() { return state().hasActionPoint(); },
+                 HasActionPoint(state()),
                  [this]() { return doNextFightersMove(); },
                  "doNextFightersMove", StepType::ALLOW_MULTITASK);
 
@@ -120,7 +104,7 @@ bool RushWithAircraft::doNextFightersMove()
     if (isMoveAllowed)
     {
         pushNextStep([this]() { return shouldAbort(); }, 
-                     [this]() { return state().hasActionPoint(); }, 
+                     HasActionPoint(state()), 
                      [this, moveVector]() { state().setMoveAction(moveVector); return true; },
                      "fighters rush");
     }
@@ -151,7 +135,7 @@ RushWithAircraft::TargetInfo RushWithAircraft::getFightersTargetInfo()
         assert(target.m_type != VehicleType::_UNKNOWN_);
 
         const VehicleGroup& targetGroup  = *target.m_group;
-        const double        damage       = std::max(0.0, targetGroup.m_units.front().lock()->getAerialDamage() - myDefense);
+        const double        damage       = std::max(0.0, targetGroup.front().getAerialDamage() - myDefense);
         const double        healthFactor = targetGroup.m_healthSum / fighters.m_healthSum;
 
         target.m_dangerFactor = damage * healthFactor;
@@ -163,7 +147,7 @@ RushWithAircraft::TargetInfo RushWithAircraft::getFightersTargetInfo()
             const VehicleGroup& defender = state().alliens(defenderType);
             if (target.m_type != defenderType && !defender.m_units.empty() && targetGroup.m_rect.overlaps(defender.m_rect))
             {
-                const double defDamage       = std::max(0.0, defender.m_units.front().lock()->getAerialDamage() - myDefense);
+                const double defDamage       = std::max(0.0, defender.front().getAerialDamage() - myDefense);
                 const double defHealthFactor = defender.m_healthSum / fighters.m_healthSum;
 
                 target.m_dangerFactor += defDamage * defHealthFactor;
@@ -172,9 +156,13 @@ RushWithAircraft::TargetInfo RushWithAircraft::getFightersTargetInfo()
 
         // compute min distance to my corner. Use corners here in order to avoid O(N^2)
 
+        const VehicleGrid::Filter targetFilter = VehicleGrid::Filter::memberOf(targetGroup);
         for (const Point& corner : myCorners)
-            for (const VehicleCache& enemyCache : targetGroup.m_units)
-                target.m_minSqDistance = std::min(target.m_minSqDistance, corner.getSquareDistance(*enemyCache.lock()));
+        {
+            const VehicleGrid::Slot nearestSlot = state().vehicleGrid().nearest(corner, targetFilter);
+            if (nearestSlot != VehicleStore::INVALID_SLOT)
+                target.m_minSqDistance = std::min(target.m_minSqDistance, corner.getSquareDistance(state().getAllVehicles().point(nearestSlot)));
+        }
     }
 
     // targets already sorted by priority, stable sort by danger factor...
@@ -214,10 +202,7 @@ bool RushWithAircraft::validateMoveVector(Vec2d& moveVector)
     static const double k_minStep = state().game()->getFighterSpeed() / 8;
 
     if (isMoveAllowed)
-    {
-        static const double simulationsStep = k_minStep;
-        isMoveAllowed = fighters.isPathFree(fighters.m_center + moveVector, Obstacle(helicopterGroup()), k_minStep);
-    }
+        isMoveAllowed = state().isPathFree(fighters, fighters.m_center + moveVector, helicopterGroup());
 
     if (!isMoveAllowed && moveVector.length() > k_minStep)
     {
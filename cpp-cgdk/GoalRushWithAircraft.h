@@ -18,7 +18,7 @@ namespace goals
 
             TargetInfo(const VehicleGroup& group)
                 : m_group(&group)
-                , m_type(group.m_units.empty() ? model::VehicleType::_UNKNOWN_ : group.m_units.front().lock()->getType())
+                , m_type(group.m_units.empty() ? model::VehicleType::_UNKNOWN_ : group.front().getType())
                 , m_dangerFactor(0)
                 , m_minSqDistance(std::numeric_limits<double>::max())
             {}
@@ -0,0 +1,111 @@
+#include "GoalScheduler.h"
+#include <algorithm>
+
+#include "goal.h"
+#include "state.h"
+
+void GoalScheduler::wake(Goal* goal, int tick)
+{
+    goal->m_isSleeping = false;
+    goal->m_wakeTick   = tick;
+}
+
+bool GoalScheduler::sleep(Goal* goal, const WakeCondition& condition, const State& state)
+{
+    const int tick = state.world()->getTickIndex();
+
+    switch (condition.m_type)
+    {
+    case WakeCondition::Type::eTICK:
+        if (condition.m_tick <= tick)
+            return false;
+
+        m_wheel[condition.m_tick % WHEEL_SIZE].push_back(TimerEntry{ goal, condition.m_tick });
+        return true;
+
+    case WakeCondition::Type::eACTION_POINT:
+        m_actionPointWaiters.push_back(goal);
+        return true;
+
+    case WakeCondition::Type::eGROUP_STOPS:
+    case WakeCondition::Type::eGROUP_AT_POINT:
+        m_groupWaiters.push_back(GroupWaiter{ goal, condition, condition.m_group->m_rect, condition.m_group->m_center });
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void GoalScheduler::cancel(const Goal* goal)
+{
+    for (std::vector<TimerEntry>& bucket : m_wheel)
+        bucket.erase(std::remove_if(bucket.begin(), bucket.end(), [goal](const TimerEntry& entry) { return entry.m_goal == goal; }), bucket.end());
+
+    m_actionPointWaiters.erase(std::remove(m_actionPointWaiters.begin(), m_actionPointWaiters.end(), goal), m_actionPointWaiters.end());
+
+    m_groupWaiters.erase(std::remove_if(m_groupWaiters.begin(), m_groupWaiters.end(), [goal](const GroupWaiter& waiter) { return waiter.m_goal == goal; }),
+                         m_groupWaiters.end());
+}
+
+void GoalScheduler::update(const State& state)
+{
+    const int tick = state.world()->getTickIndex();
+
+    // timers: visit buckets of ticks passed since previous update, all of them at most once
+    const int firstTick = m_lastTick < 0 ? tick : std::max(m_lastTick + 1, tick - WHEEL_SIZE + 1);
+    for (int t = firstTick; t <= tick; ++t)
+    {
+        std::vector<TimerEntry>& bucket = m_wheel[t % WHEEL_SIZE];
+        for (size_t i = 0; i < bucket.size(); )
+        {
+            if (bucket[i].m_tick > tick)
+            {
+                ++i;
+                continue;   // one of the next rounds
+            }
+
+            wake(bucket[i].m_goal, tick);
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+        }
+    }
+
+    m_lastTick = tick;
+
+    if (state.hasActionPoint())
+    {
+        for (Goal* goal : m_actionPointWaiters)
+            wake(goal, tick);
+
+        m_actionPointWaiters.clear();
+    }
+
+    for (size_t i = 0; i < m_groupWaiters.size(); )
+    {
+        GroupWaiter&        waiter = m_groupWaiters[i];
+        const VehicleGroup& group  = *waiter.m_condition.m_group;
+
+        bool isFired = false;
+        if (waiter.m_condition.m_type == WakeCondition::Type::eGROUP_STOPS)
+        {
+            isFired = group.m_rect == waiter.m_lastRect && group.m_center == waiter.m_lastCenter;
+            waiter.m_lastRect   = group.m_rect;
+            waiter.m_lastCenter = group.m_center;
+        }
+        else
+        {
+            isFired = group.m_center == waiter.m_condition.m_point;
+        }
+
+        if (!isFired)
+        {
+            ++i;
+            continue;
+        }
+
+        wake(waiter.m_goal, tick);
+        m_groupWaiters[i] = m_groupWaiters.back();
+        m_groupWaiters.pop_back();
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+
+#include "geometry.h"
+#include "WakeCondition.h"
+
+class Goal;
+class State;
+
+// Wakes sleeping goals when their conditions fire. Tick conditions are kept in a timer wheel, so a goal waiting
+// for some ticks isn't touched until then; action point waiters are woken all at once; group waiters are checked
+// by group state only, without calling any goal code
+class GoalScheduler
+{
+public:
+    static const int WHEEL_SIZE = 64;
+
+    // goal's current step didn't proceed. Returns false when it has to be polled, i.e. there is no condition
+    bool sleep(Goal* goal, const WakeCondition& condition, const State& state);
+
+    // forget the goal, e.g. when it's destroyed while sleeping
+    void cancel(const Goal* goal);
+
+    // fires conditions of the current tick, called once per tick before goals
+    void update(const State& state);
+
+private:
+    struct TimerEntry
+    {
+        Goal* m_goal;
+        int   m_tick;
+    };
+
+    struct GroupWaiter
+    {
+        Goal*         m_goal;
+        WakeCondition m_condition;
+        Rect          m_lastRect;
+        Point         m_lastCenter;
+    };
+
+    static void wake(Goal* goal, int tick);
+
+    std::vector<TimerEntry>  m_wheel[WHEEL_SIZE];     // by tick % WHEEL_SIZE, later rounds stay in their bucket
+    std::vector<Goal*>       m_actionPointWaiters;
+    std::vector<GroupWaiter> m_groupWaiters;
+    int                      m_lastTick = -1;
+};
@@ -0,0 +1,221 @@
+#include "GroupPathfinder.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+static bool isAerial(model::VehicleType type)
+{
+    return type == model::VehicleType::FIGHTER || type == model::VehicleType::HELICOPTER;
+}
+
+size_t GroupPathfinder::KeyHash::operator()(const Key& key) const
+{
+    // http://stackoverflow.com/a/1646913/126995
+    size_t res = 17;
+    res = res * 31 + std::hash<int>()(key.m_type);
+    res = res * 31 + std::hash<int>()(key.m_from);
+    res = res * 31 + std::hash<int>()(key.m_to);
+    res = res * 31 + key.m_obstaclesHash;
+    return res;
+}
+
+void GroupPathfinder::init(int width, int height, double tileSize, std::vector<double>&& groundMobility, std::vector<double>&& airMobility)
+{
+    m_width          = width;
+    m_height         = height;
+    m_tileSize       = tileSize;
+    m_groundMobility = std::move(groundMobility);
+    m_airMobility    = std::move(airMobility);
+
+    m_maxMobility = 0;
+    for (double factor : m_groundMobility)
+        m_maxMobility = std::max(m_maxMobility, factor);
+    for (double factor : m_airMobility)
+        m_maxMobility = std::max(m_maxMobility, factor);
+
+    m_cache.clear();
+}
+
+int GroupPathfinder::tileIndex(const Point& p) const
+{
+    const int x = std::min(std::max(static_cast<int>(p.m_x / m_tileSize), 0), m_width - 1);
+    const int y = std::min(std::max(static_cast<int>(p.m_y / m_tileSize), 0), m_height - 1);
+    return x * m_height + y;
+}
+
+Point GroupPathfinder::tileCenter(int tile) const
+{
+    return Point((tile / m_height + 0.5) * m_tileSize, (tile % m_height + 0.5) * m_tileSize);
+}
+
+void GroupPathfinder::markBlocked(const Rect& groupRect, const std::vector<Rect>& obstacles)
+{
+    m_blocked.assign(static_cast<size_t>(m_width) * m_height, 0);
+
+    // the group is a point in the space of obstacles inflated by its half size
+    const Point halfSize(groupRect.width() / 2, groupRect.height() / 2);
+
+    for (const Rect& obstacle : obstacles)
+    {
+        const Rect inflated = obstacle.inflate(halfSize);
+
+        const int minX = std::max(0,            static_cast<int>(std::floor(inflated.m_topLeft.m_x / m_tileSize)));
+        const int minY = std::max(0,            static_cast<int>(std::floor(inflated.m_topLeft.m_y / m_tileSize)));
+        const int maxX = std::min(m_width - 1,  static_cast<int>(std::floor(inflated.m_bottomRight.m_x / m_tileSize)));
+        const int maxY = std::min(m_height - 1, static_cast<int>(std::floor(inflated.m_bottomRight.m_y / m_tileSize)));
+
+        for (int x = minX; x <= maxX; ++x)
+            for (int y = minY; y <= maxY; ++y)
+                if (inflated.contains(tileCenter(x * m_height + y)))
+                    m_blocked[x * m_height + y] = 1;
+    }
+}
+
+bool GroupPathfinder::findPath(model::VehicleType type, const Rect& groupRect, const Point& destination, const std::vector<Rect>& obstacles, std::vector<Point>& path)
+{
+    path.clear();
+    if (!isInitialized())
+        return false;
+
+    const Point halfSize(groupRect.width() / 2, groupRect.height() / 2);
+    for (const Rect& obstacle : obstacles)
+        if (obstacle.inflate(halfSize).contains(destination))
+            return false;
+
+    const int from = tileIndex(groupRect.center());
+    const int to   = tileIndex(destination);
+
+    markBlocked(groupRect, obstacles);
+    m_blocked[from] = m_blocked[to] = 0;    // exact positions are free, their tile centers may be not
+
+    size_t obstaclesHash = 17;
+    for (uint8_t isBlocked : m_blocked)
+        obstaclesHash = obstaclesHash * 31 + isBlocked;
+
+    const Key key{ static_cast<int>(type), from, to, obstaclesHash };
+
+    auto found = m_cache.find(key);
+    if (found == m_cache.end())
+    {
+        CachedPath result;
+        result.m_isFound = search(isAerial(type) ? m_airMobility : m_groundMobility, from, to, result.m_tiles);
+        found = m_cache.emplace(key, std::move(result)).first;
+    }
+
+    const CachedPath& cached = found->second;
+    if (!cached.m_isFound)
+        return false;
+
+    // the last turning point is the destination tile, the exact destination is used instead
+    for (size_t i = 0; i + 1 < cached.m_tiles.size(); ++i)
+        path.push_back(tileCenter(cached.m_tiles[i]));
+
+    path.push_back(destination);
+    return true;
+}
+
+bool GroupPathfinder::search(const std::vector<double>& mobility, int from, int to, std::vector<int>& tiles)
+{
+    tiles.clear();
+    if (from == to)
+    {
+        tiles.push_back(to);
+        return true;
+    }
+
+    const size_t tilesCount = static_cast<size_t>(m_width) * m_height;
+
+    m_cost.assign(tilesCount, std::numeric_limits<double>::max());
+    m_parent.assign(tilesCount, -1);
+    m_isClosed.assign(tilesCount, 0);
+
+    static const double SQRT2 = std::sqrt(2.0);
+
+    // octile distance at the best possible speed
+    auto heuristic = [this, to](int tile)
+    {
+        const int dx = std::abs(tile / m_height - to / m_height);
+        const int dy = std::abs(tile % m_height - to % m_height);
+        return (std::max(dx, dy) + (SQRT2 - 1) * std::min(dx, dy)) * m_tileSize / m_maxMobility;
+    };
+
+    typedef std::pair<double, int> OpenItem;   // estimated total cost, tile
+    std::vector<OpenItem> open;
+    open.reserve(tilesCount);
+
+    m_cost[from] = 0;
+    open.emplace_back(heuristic(from), from);
+
+    while (!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), std::greater<OpenItem>());
+        const int tile = open.back().second;
+        open.pop_back();
+
+        if (m_isClosed[tile])
+            continue;
+
+        m_isClosed[tile] = 1;
+        if (tile == to)
+            break;
+
+        const int x = tile / m_height;
+        const int y = tile % m_height;
+
+        for (int dx = -1; dx <= 1; ++dx)
+        {
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                const int nx = x + dx;
+                const int ny = y + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= m_width || ny >= m_height)
+                    continue;
+
+                const int next = nx * m_height + ny;
+                if (m_blocked[next] || m_isClosed[next])
+                    continue;
+
+                const bool isDiagonal = dx != 0 && dy != 0;
+                if (isDiagonal && (m_blocked[nx * m_height + y] || m_blocked[x * m_height + ny]))
+                    continue;   // don't cut corners of obstacles
+
+                // time to cross half of each tile
+                const double length = (isDiagonal ? SQRT2 : 1.0) * m_tileSize;
+                const double cost   = m_cost[tile] + length * 0.5 * (1 / mobility[tile] + 1 / mobility[next]);
+
+                if (cost < m_cost[next])
+                {
+                    m_cost[next]   = cost;
+                    m_parent[next] = tile;
+                    open.emplace_back(cost + heuristic(next), next);
+                    std::push_heap(open.begin(), open.end(), std::greater<OpenItem>());
+                }
+            }
+        }
+    }
+
+    if (!m_isClosed[to])
+        return false;
+
+    // walk back, keeping only tiles where direction changes
+    int current = to;
+    int lastDx  = 0;
+    int lastDy  = 0;
+    while (current != from)
+    {
+        const int parent = m_parent[current];
+        const int dx = current / m_height - parent / m_height;
+        const int dy = current % m_height - parent % m_height;
+
+        if (current == to || dx != lastDx || dy != lastDy)
+            tiles.push_back(current);
+
+        lastDx  = dx;
+        lastDy  = dy;
+        current = parent;
+    }
+
+    std::reverse(tiles.begin(), tiles.end());
+    return true;
+}
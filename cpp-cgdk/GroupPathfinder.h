@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "geometry.h"
+#include "model/VehicleType.h"
+
+// A* over terrain/weather tiles for a whole group. Step cost is the time to cross tiles at their mobility factor,
+// tiles where the group rect would overlap an obstacle rect are blocked. Every tile is expanded at most once,
+// so a query is bounded by the tile count. Paths are cached until clearCache(), State clears it every tick.
+class GroupPathfinder
+{
+public:
+    // mobility factors by tile, x-major like model::CellGrid
+    void init(int width, int height, double tileSize, std::vector<double>&& groundMobility, std::vector<double>&& airMobility);
+
+    bool isInitialized() const        { return m_width > 0; }
+    void clearCache()                 { m_cache.clear(); }
+
+    // waypoints from groupRect center to destination, the last one is destination itself.
+    // Returns false when the destination can't be reached
+    bool findPath(model::VehicleType type, const Rect& groupRect, const Point& destination, const std::vector<Rect>& obstacles, std::vector<Point>& path);
+
+private:
+    struct Key
+    {
+        int    m_type;
+        int    m_from;
+        int    m_to;
+        size_t m_obstaclesHash;
+
+        bool operator==(const Key& right) const
+        {
+            return m_type == right.m_type && m_from == right.m_from && m_to == right.m_to && m_obstaclesHash == right.m_obstaclesHash;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct CachedPath
+    {
+        bool               m_isFound;
+        std::vector<int>   m_tiles;     // turning points only, without the start tile
+    };
+
+    int   tileIndex(const Point& p) const;
+    Point tileCenter(int tile) const;
+
+    void markBlocked(const Rect& groupRect, const std::vector<Rect>& obstacles);
+    bool search(const std::vector<double>& mobility, int from, int to, std::vector<int>& tiles);
+
+    int    m_width    = 0;
+    int    m_height   = 0;
+    double m_tileSize = 0;
+    double m_maxMobility = 1;
+
+    std::vector<double> m_groundMobility;
+    std::vector<double> m_airMobility;
+
+    // search buffers, kept between queries
+    std::vector<uint8_t> m_blocked;
+    std::vector<double>  m_cost;
+    std::vector<int>     m_parent;
+    std::vector<uint8_t> m_isClosed;
+
+    std::unordered_map<Key, CachedPath, KeyHash> m_cache;
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// bool() callable kept inside the object, like std::function but never on the heap.
+// Captures have to fit into CAPACITY, this is checked at compile time: capture 'this' and references
+// instead of copying big objects.
+class InplaceCallback
+{
+public:
+    static const size_t CAPACITY = 64;
+
+    InplaceCallback() {}
+
+    template <typename Functor, typename = typename std::enable_if<!std::is_same<typename std::decay<Functor>::type, InplaceCallback>::value>::type>
+    InplaceCallback(Functor&& functor)
+    {
+        typedef typename std::decay<Functor>::type Stored;
+        static_assert(sizeof(Stored) <= CAPACITY, "callable captures too much for InplaceCallback");
+        static_assert(alignof(Stored) <= alignof(Storage), "callable is over-aligned for InplaceCallback");
+
+        new (&m_storage) Stored(std::forward<Functor>(functor));
+        m_ops = &Ops<Stored>::s_table;
+    }
+
+    InplaceCallback(const InplaceCallback& other)              { copyFrom(other); }
+    InplaceCallback(InplaceCallback&& other)                   { moveFrom(other); }
+    ~InplaceCallback()                                         { reset(); }
+
+    InplaceCallback& operator=(const InplaceCallback& other)   { if (this != &other) { reset(); copyFrom(other); } return *this; }
+    InplaceCallback& operator=(InplaceCallback&& other)        { if (this != &other) { reset(); moveFrom(other); } return *this; }
+
+    // stored callables may keep state between calls, like std::function does
+    bool operator()() const                                    { return m_ops->m_invoke(&m_storage); }
+    explicit operator bool() const                             { return m_ops != nullptr; }
+
+private:
+    typedef std::aligned_storage<CAPACITY, alignof(std::max_align_t)>::type Storage;
+
+    struct Table
+    {
+        bool (*m_invoke)(void* callable);
+        void (*m_copy)(void* to, const void* from);
+        void (*m_move)(void* to, void* from);
+        void (*m_destroy)(void* callable);
+    };
+
+    template <typename Stored>
+    struct Ops
+    {
+        static bool invoke(void* callable)              { return (*static_cast<Stored*>(callable))(); }
+        static void copy(void* to, const void* from)    { new (to) Stored(*static_cast<const Stored*>(from)); }
+        static void move(void* to, void* from)          { new (to) Stored(std::move(*static_cast<Stored*>(from))); }
+        static void destroy(void* callable)             { static_cast<Stored*>(callable)->~Stored(); }
+
+        static const Table s_table;
+    };
+
+    void reset()
+    {
+        if (m_ops)
+            m_ops->m_destroy(&m_storage);
+        m_ops = nullptr;
+    }
+
+    void copyFrom(const InplaceCallback& other)
+    {
+        if (other.m_ops)
+            other.m_ops->m_copy(&m_storage, &other.m_storage);
+        m_ops = other.m_ops;
+    }
+
+    void moveFrom(InplaceCallback& other)
+    {
+        if (other.m_ops)
+            other.m_ops->m_move(&m_storage, &other.m_storage);
+        m_ops = other.m_ops;
+    }
+
+    mutable Storage m_storage;
+    const Table*    m_ops = nullptr;
+};
+
+template <typename Stored>
+const InplaceCallback::Table InplaceCallback::Ops<Stored>::s_table = { &invoke, &copy, &move, &destroy };
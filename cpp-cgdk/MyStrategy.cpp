@@ -20,6 +20,11 @@ void MyStrategy::move(const Player& me, const World& world, const Game& game, Mo
     m_debug.commitFrame();
 }
 
+VehicleUpdateSink* MyStrategy::getVehicleUpdateSink()
+{
+    return &m_state;
+}
+
 MyStrategy::MyStrategy()
     : m_state()
     , m_goalManager(m_state)
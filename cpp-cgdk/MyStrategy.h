@@ -14,6 +14,8 @@ public:
 
     void move(const model::Player& me, const model::World& world, const model::Game& game, model::Move& move) override;
 
+    VehicleUpdateSink* getVehicleUpdateSink() override;
+
 private:
     State       m_state;
     GoalManager m_goalManager;
@@ -0,0 +1,169 @@
+#include "NukeDamageGrid.h"
+#include <algorithm>
+#include <cmath>
+
+// cells are large enough that a strike circle covers only ~ (2 * k_cellsPerRadius + 1)^2 of them
+static const double k_cellsPerRadius    = 4;
+
+const double NukeDamageGrid::MAX_UNIT_ERROR = 1;
+
+NukeDamageGrid::NukeDamageGrid(const VehicleStore& store, double strikeRadius, double maxDamage, double teammateDamageFactor)
+    : m_store(store)
+    , m_strikeRadius(strikeRadius)
+    , m_maxDamage(maxDamage)
+    , m_decaySpeed(strikeRadius / maxDamage)
+    , m_teammateFactor(teammateDamageFactor)
+{
+}
+
+int NukeDamageGrid::cellX(double x) const
+{
+    int cell = static_cast<int>((x - m_origin.m_x) / m_cellSize);
+    return std::min(std::max(cell, 0), m_width - 1);
+}
+
+int NukeDamageGrid::cellY(double y) const
+{
+    int cell = static_cast<int>((y - m_origin.m_y) / m_cellSize);
+    return std::min(std::max(cell, 0), m_height - 1);
+}
+
+void NukeDamageGrid::build(const Rect& bounds, const std::vector<Slot>& units, const std::vector<Point>& positions)
+{
+    m_cellSize = m_strikeRadius / k_cellsPerRadius;
+    m_origin   = bounds.m_topLeft;
+    m_width    = static_cast<int>(bounds.width() / m_cellSize) + 1;
+    m_height   = static_cast<int>(bounds.height() / m_cellSize) + 1;
+
+    m_cells.assign(static_cast<size_t>(m_width) * m_height, Cell());
+    m_units.resize(units.size());
+
+    // counting sort by cell, so every cell owns a contiguous range of m_units
+
+    std::vector<uint32_t> cellOfUnit(units.size());
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        const Point& p  = positions[i];
+        uint32_t cell   = static_cast<uint32_t>(cellX(p.m_x) * m_height + cellY(p.m_y));
+        Cell&    target = m_cells[cell];
+
+        cellOfUnit[i] = cell;
+        ++target.m_count;
+
+        const double squaredLength = p.m_x * p.m_x + p.m_y * p.m_y;
+        if (m_store.isMine(units[i]))
+        {
+            target.m_mineCount      += 1;
+            target.m_mineSum        += p;
+            target.m_mineSquaredSum += squaredLength;
+        }
+        else
+        {
+            target.m_enemyCount      += 1;
+            target.m_enemySum        += p;
+            target.m_enemySquaredSum += squaredLength;
+        }
+    }
+
+    uint32_t first = 0;
+    for (Cell& cell : m_cells)
+    {
+        cell.m_first = first;
+        first += cell.m_count;
+        cell.m_count = 0;
+    }
+
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        Cell& cell = m_cells[cellOfUnit[i]];
+        m_units[cell.m_first + cell.m_count++] = Entry{ positions[i], m_store.isMine(units[i]) };
+    }
+}
+
+double NukeDamageGrid::unitDamage(const Point& hitPoint, const Point& unitPosition, bool isMine) const
+{
+    double real = std::max(0.0, m_maxDamage - (hitPoint.getDistanceTo(unitPosition) / m_decaySpeed));
+
+    return (isMine ? m_teammateFactor : 1.0) * real;
+}
+
+// For |p - hit| expanded around centroid c the linear terms cancel over the cell, and the curvature of the distance
+// is at most 1 / nearDistance, so 0 <= mean |p - hit| - |c - hit| <= variance / (2 * nearDistance).
+// Damage falls linearly with distance, so the centroid overestimates it by at most that divided by decay speed
+double NukeDamageGrid::centroidDamage(const Point& hitPoint, double count, const Point& sum, double squaredSum, double nearDistance, bool& isExact) const
+{
+    if (count == 0)
+        return 0;
+
+    const Point  centroid = sum / count;
+    const double variance = std::max(0.0, squaredSum / count - (centroid.m_x * centroid.m_x + centroid.m_y * centroid.m_y));
+
+    if (variance > 2 * nearDistance * m_decaySpeed * MAX_UNIT_ERROR)
+    {
+        isExact = false;
+        return 0;
+    }
+
+    return count * (m_maxDamage - hitPoint.getDistanceTo(centroid) / m_decaySpeed);
+}
+
+double NukeDamageGrid::damageAt(const Point& hitPoint) const
+{
+    if (m_cells.empty())
+        return 0;
+
+    const double squaredRadius     = m_strikeRadius * m_strikeRadius;
+
+    const int minX = cellX(hitPoint.m_x - m_strikeRadius);
+    const int maxX = cellX(hitPoint.m_x + m_strikeRadius);
+    const int minY = cellY(hitPoint.m_y - m_strikeRadius);
+    const int maxY = cellY(hitPoint.m_y + m_strikeRadius);
+
+    double damage = 0;
+
+    for (int x = minX; x <= maxX; ++x)
+    {
+        const double left  = m_origin.m_x + x * m_cellSize;
+        const double right = left + m_cellSize;
+        const double nearDx = std::max(0.0, std::max(left - hitPoint.m_x, hitPoint.m_x - right));
+        const double farDx  = std::max(std::abs(hitPoint.m_x - left), std::abs(hitPoint.m_x - right));
+
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const Cell& cell = m_cells[x * m_height + y];
+            if (cell.m_count == 0)
+                continue;
+
+            const double top    = m_origin.m_y + y * m_cellSize;
+            const double bottom = top + m_cellSize;
+            const double nearDy = std::max(0.0, std::max(top - hitPoint.m_y, hitPoint.m_y - bottom));
+            const double farDy  = std::max(std::abs(hitPoint.m_y - top), std::abs(hitPoint.m_y - bottom));
+
+            const double squaredNear = nearDx * nearDx + nearDy * nearDy;
+            if (squaredNear >= squaredRadius)
+                continue;   // whole cell is out of reach
+
+            if (farDx * farDx + farDy * farDy <= squaredRadius)
+            {
+                // whole cell is inside, centroids are used while their error is within MAX_UNIT_ERROR
+                const double nearDistance = std::sqrt(squaredNear);
+
+                bool isExact = true;
+                const double enemyDamage = centroidDamage(hitPoint, cell.m_enemyCount, cell.m_enemySum, cell.m_enemySquaredSum, nearDistance, isExact);
+                const double mineDamage  = centroidDamage(hitPoint, cell.m_mineCount,  cell.m_mineSum,  cell.m_mineSquaredSum,  nearDistance, isExact);
+
+                if (isExact)
+                {
+                    damage += enemyDamage + m_teammateFactor * mineDamage;
+                    continue;
+                }
+            }
+
+            // cell crosses strike border, or its units are spread too much for the hit point this close
+            for (uint32_t i = cell.m_first; i < cell.m_first + cell.m_count; ++i)
+                damage += unitDamage(hitPoint, m_units[i].m_position, m_units[i].m_isMine);
+        }
+    }
+
+    return damage;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+#include "VehicleStore.h"
+
+// Estimates total nuclear strike damage at a hit point without visiting every unit.
+// Units are binned into cells a few times smaller than strike radius. Cells entirely outside of
+// the strike circle are skipped, cells entirely inside contribute by their centroids, and only
+// cells crossed by the circle border are summed unit by unit. Distance is convex, so a centroid
+// overestimates damage of its cell; the overestimate is bounded by spread of the cell units and
+// cells whose bound exceeds MAX_UNIT_ERROR per unit are summed unit by unit as well.
+class NukeDamageGrid
+{
+public:
+    typedef VehicleStore::Slot Slot;
+
+    static const double MAX_UNIT_ERROR;     // damage per unit of a cell summed by its centroid, scaled by teammate factor for mine
+
+    NukeDamageGrid(const VehicleStore& store, double strikeRadius, double maxDamage, double teammateDamageFactor);
+
+    // units may be both mine and enemy, positions are parallel to units (e.g. predicted ones) and should be inside of bounds
+    void build(const Rect& bounds, const std::vector<Slot>& units, const std::vector<Point>& positions);
+
+    double damageAt(const Point& hitPoint) const;
+
+    // exact damage to single unit, the same falloff damageAt() uses
+    double unitDamage(const Point& hitPoint, const Point& unitPosition, bool isMine) const;
+
+private:
+    struct Entry
+    {
+        Point m_position;
+        bool  m_isMine;
+    };
+
+    struct Cell
+    {
+        double   m_enemyCount = 0;
+        Point    m_enemySum;            // sum of enemy positions, centroid = sum / count
+        double   m_enemySquaredSum = 0; // sum of squared position lengths, gives spread around the centroid
+        double   m_mineCount  = 0;
+        Point    m_mineSum;
+        double   m_mineSquaredSum = 0;
+        uint32_t m_first      = 0;      // range in m_units
+        uint32_t m_count      = 0;
+    };
+
+    double centroidDamage(const Point& hitPoint, double count, const Point& sum, double squaredSum, double nearDistance, bool& isExact) const;
+
+    int cellX(double x) const;
+    int cellY(double y) const;
+
+    const VehicleStore& m_store;
+    const double        m_strikeRadius;
+    const double        m_maxDamage;
+    const double        m_decaySpeed;
+    const double        m_teammateFactor;
+
+    double              m_cellSize = 1;
+    Point               m_origin;
+    int                 m_width    = 0;
+    int                 m_height   = 0;
+    std::vector<Cell>   m_cells;        // x-major, index is x * m_height + y
+    std::vector<Entry>  m_units;        // grouped by cell
+};
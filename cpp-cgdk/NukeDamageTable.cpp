@@ -0,0 +1,129 @@
+#include "NukeDamageTable.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+static const double k_cellsPerRadius = 8;
+static const int    k_kernelLayers   = 4;
+
+NukeDamageTable::NukeDamageTable(const VehicleStore& store, double strikeRadius, double maxDamage, double teammateDamageFactor)
+    : m_store(store)
+    , m_strikeRadius(strikeRadius)
+    , m_maxDamage(maxDamage)
+    , m_teammateFactor(teammateDamageFactor)
+{
+}
+
+void NukeDamageTable::build(const Rect& bounds, const Rect& area, const std::vector<Slot>& units, const std::vector<Point>& positions)
+{
+    m_cellSize = m_strikeRadius / k_cellsPerRadius;
+    m_origin   = bounds.m_topLeft;
+    m_width    = static_cast<int>(bounds.width() / m_cellSize) + 1;
+    m_height   = static_cast<int>(bounds.height() / m_cellSize) + 1;
+
+    // damage is maxDamage * (1 - d / R), i.e. a sum of k_kernelLayers discs with radii R * k / layers,
+    // each disc is replaced by the square of the same area
+    static const double k_squarePerDisc = std::sqrt(3.14159265358979323846) / 2;
+
+    m_halfSizes.clear();
+    for (int layer = 1; layer <= k_kernelLayers; ++layer)
+    {
+        const double halfSide = m_strikeRadius * layer / k_kernelLayers * k_squarePerDisc;
+        m_halfSizes.push_back(std::max(0, static_cast<int>(std::round(halfSide / m_cellSize - 0.5))));
+    }
+
+    // rasterize weights
+
+    const int stride = m_height + 1;
+    m_sums.assign(static_cast<size_t>(m_width + 1) * stride, 0.0);
+
+    for (size_t i = 0; i < units.size(); ++i)
+    {
+        const Point& p = positions[i];
+        const int   x = static_cast<int>((p.m_x - m_origin.m_x) / m_cellSize);
+        const int   y = static_cast<int>((p.m_y - m_origin.m_y) / m_cellSize);
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            continue;
+
+        m_sums[(x + 1) * stride + (y + 1)] += m_store.isMine(units[i]) ? m_teammateFactor : 1.0;
+    }
+
+    // integrate in place
+
+    for (int x = 1; x <= m_width; ++x)
+        for (int y = 1; y <= m_height; ++y)
+            m_sums[x * stride + y] += m_sums[(x - 1) * stride + y] + m_sums[x * stride + y - 1] - m_sums[(x - 1) * stride + y - 1];
+
+    // estimates inside of area only, the rest is never a candidate
+
+    m_estimates.assign(static_cast<size_t>(m_width) * m_height, std::numeric_limits<double>::lowest());
+
+    for (int x = 0; x < m_width; ++x)
+        for (int y = 0; y < m_height; ++y)
+            if (area.contains(cellCenter(x, y)))
+                m_estimates[x * m_height + y] = estimate(x, y);
+}
+
+double NukeDamageTable::boxSum(int minX, int minY, int maxX, int maxY) const
+{
+    minX = std::max(minX, 0);
+    minY = std::max(minY, 0);
+    maxX = std::min(maxX, m_width - 1);
+    maxY = std::min(maxY, m_height - 1);
+    if (minX > maxX || minY > maxY)
+        return 0;
+
+    const int stride = m_height + 1;
+    return m_sums[(maxX + 1) * stride + (maxY + 1)] - m_sums[minX * stride + (maxY + 1)]
+         - m_sums[(maxX + 1) * stride + minY]       + m_sums[minX * stride + minY];
+}
+
+double NukeDamageTable::estimate(int x, int y) const
+{
+    double damage = 0;
+    for (int half : m_halfSizes)
+        damage += boxSum(x - half, y - half, x + half, y + half);
+
+    return damage * m_maxDamage / k_kernelLayers;
+}
+
+void NukeDamageTable::bestPoints(const Point& center, double radius, size_t count, std::vector<Point>& result) const
+{
+    result.clear();
+    if (m_estimates.empty() || count == 0)
+        return;
+
+    const int minX = std::max(0, static_cast<int>((center.m_x - radius - m_origin.m_x) / m_cellSize));
+    const int minY = std::max(0, static_cast<int>((center.m_y - radius - m_origin.m_y) / m_cellSize));
+    const int maxX = std::min(m_width - 1,  static_cast<int>((center.m_x + radius - m_origin.m_x) / m_cellSize));
+    const int maxY = std::min(m_height - 1, static_cast<int>((center.m_y + radius - m_origin.m_y) / m_cellSize));
+
+    const double squaredRadius = radius * radius;
+
+    typedef std::pair<double, Point> Candidate;
+    std::vector<Candidate> best;     // kept sorted DESC, count is small
+    best.reserve(count + 1);
+
+    for (int x = minX; x <= maxX; ++x)
+    {
+        for (int y = minY; y <= maxY; ++y)
+        {
+            const double damage = m_estimates[x * m_height + y];
+            if (damage <= 0 || (best.size() == count && damage <= best.back().first))
+                continue;
+
+            const Point point = cellCenter(x, y);
+            if (center.getSquareDistance(point) > squaredRadius)
+                continue;
+
+            auto it = std::upper_bound(best.begin(), best.end(), damage, [](double value, const Candidate& c) { return value > c.first; });
+            best.emplace(it, damage, point);
+            if (best.size() > count)
+                best.pop_back();
+        }
+    }
+
+    for (const Candidate& candidate : best)
+        result.push_back(candidate.second);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+
+#include "geometry.h"
+#include "VehicleStore.h"
+
+// Dense estimate of nuclear strike damage for every point of a fine raster.
+// Unit weights (enemies positive, teammates negative) are accumulated into a summed-area table,
+// and the cone shaped damage falloff is approximated by a stack of nested squares, each of them
+// costs four table lookups. It's used to pick candidate hit points anywhere, not only at unit
+// positions; candidates are expected to be re-scored exactly by NukeDamageGrid.
+class NukeDamageTable
+{
+public:
+    typedef VehicleStore::Slot Slot;
+
+    NukeDamageTable(const VehicleStore& store, double strikeRadius, double maxDamage, double teammateDamageFactor);
+
+    // positions are parallel to units, units outside of bounds are ignored. Estimates are computed for cells with center inside area,
+    // area should be at least strike radius away from bounds border
+    void build(const Rect& bounds, const Rect& area, const std::vector<Slot>& units, const std::vector<Point>& positions);
+
+    // up to count best cell centers within radius of center, sorted by estimated damage DESC
+    void bestPoints(const Point& center, double radius, size_t count, std::vector<Point>& result) const;
+
+private:
+    double boxSum(int minX, int minY, int maxX, int maxY) const;
+    double estimate(int x, int y) const;
+
+    Point  cellCenter(int x, int y) const { return Point(m_origin.m_x + (x + 0.5) * m_cellSize, m_origin.m_y + (y + 0.5) * m_cellSize); }
+
+    const VehicleStore& m_store;
+    const double        m_strikeRadius;
+    const double        m_maxDamage;
+    const double        m_teammateFactor;
+
+    double              m_cellSize = 1;
+    Point               m_origin;
+    int                 m_width    = 0;
+    int                 m_height   = 0;
+    std::vector<int>    m_halfSizes;     // nested squares, in cells
+    std::vector<double> m_sums;          // (m_width + 1) x (m_height + 1), x-major, zero first row and column
+    std::vector<double> m_estimates;     // per cell, lowest() for cells outside of area
+};
@@ -0,0 +1,309 @@
+#include "NukePlanner.h"
+#include <algorithm>
+#include <limits>
+
+#include "state.h"
+#include "NukeDamageGrid.h"
+#include "NukeDamageTable.h"
+
+static const double UNKNOWN_DAMAGE = -std::numeric_limits<double>::max();
+
+void NukePlanner::reset()
+{
+    m_isWarm    = false;
+    m_hasTarget = false;
+    m_best      = Target();
+}
+
+void NukePlanner::update(const State& state, const std::vector<Slot>& changed)
+{
+    if (state.player()->getRemainingNuclearStrikeCooldownTicks() > 0)
+    {
+        // nothing to plan, and caches would be stale anyway when cooldown ends
+        reset();
+        m_previousChanged = changed;
+        return;
+    }
+
+    const bool wasWarm = m_isWarm;
+    if (!wasWarm)
+    {
+        m_hitDamage.assign(state.getAllVehicles().size(), UNKNOWN_DAMAGE);
+        m_isWarm = true;
+    }
+    else
+    {
+        invalidate(state, m_previousChanged);
+        invalidate(state, changed);
+    }
+
+    // guides are filtered by damage of the enemy strike. While it flies, its target is known and time left to it
+    // changes every tick, and the tick it's gone the filter is lifted, so the result can't be reused then
+    const int  enemyStrikeTick    = state.enemy()->getNextNuclearStrikeTickIndex();
+    const bool isEnemyStrikeStale = enemyStrikeTick != -1 || m_enemyStrikeTick != -1;
+
+    // when nothing moved since last evaluation, the best target is the same
+    if (!wasWarm || !changed.empty() || !m_previousChanged.empty() || isEnemyStrikeStale)
+        evaluate(state);
+
+    m_enemyStrikeTick = enemyStrikeTick;
+
+    m_previousChanged = changed;
+}
+
+void NukePlanner::invalidate(const State& state, const std::vector<Slot>& changed)
+{
+    const VehicleStore& allVehicles = state.getAllVehicles();
+    const int           strikeDelay = state.game()->getTacticalNuclearStrikeDelay();
+
+    if (m_predicted.size() < allVehicles.size())
+    {
+        m_predicted.resize(allVehicles.size());
+        m_hasPrediction.resize(allVehicles.size(), false);
+    }
+
+    for (Slot slot : changed)
+    {
+        if (m_hasPrediction[slot])
+            invalidateAround(state, m_predicted[slot]);
+
+        m_hasPrediction[slot] = allVehicles.isAlive(slot);
+        if (m_hasPrediction[slot])
+        {
+            m_predicted[slot] = state.predictVehiclePosition(slot, strikeDelay);
+            invalidateAround(state, m_predicted[slot]);
+        }
+
+        if (slot < m_hitDamage.size())
+            m_hitDamage[slot] = UNKNOWN_DAMAGE;
+    }
+}
+
+void NukePlanner::invalidateAround(const State& state, const Point& point)
+{
+    const double nukeRadius = state.game()->getTacticalNuclearStrikeRadius();
+    const double maxTravel  = state.game()->getTacticalNuclearStrikeDelay() * state.game()->getFighterSpeed();
+
+    // grid knows current positions, hit points are predicted ones which are at most maxTravel away
+    state.vehicleGrid().forEachInRadius(point, nukeRadius + maxTravel, VehicleGrid::Filter::enemy(), [this, &point, nukeRadius](Slot enemy)
+    {
+        if (enemy < m_hitDamage.size() && m_hasPrediction[enemy] && m_predicted[enemy].getDistanceTo(point) < nukeRadius)
+            m_hitDamage[enemy] = UNKNOWN_DAMAGE;
+    });
+}
+
+void NukePlanner::evaluate(const State& state)
+{
+    m_hasTarget = false;
+    m_best      = Target();
+
+    static const double LOOKUP_RANGE = 10 * state.game()->getFighterSpeed() + state.game()->getFighterVisionRange()
+                                          + state.game()->getTacticalNuclearStrikeRadius();
+
+    if (state.getDistanceToAlliensRect() >= LOOKUP_RANGE)
+        return;
+
+    const VehicleStore& allVehicles = state.getAllVehicles();
+
+    if (m_hitDamage.size() < allVehicles.size())
+        m_hitDamage.resize(allVehicles.size(), UNKNOWN_DAMAGE);
+
+    if (m_predicted.size() < allVehicles.size())
+    {
+        m_predicted.resize(allVehicles.size());
+        m_hasPrediction.resize(allVehicles.size(), false);
+    }
+
+    Rect reachableRect = state.getTeammatesRect().inflate(LOOKUP_RANGE);
+
+    std::vector<Slot> teammates;
+    teammates.reserve(allVehicles.size());
+
+    const model::Player& enemyPlayer = *state.enemy();
+    Point enemyNuke = state.enemyNuclearMissileTarget();
+    int   ticksToEnemyNuke = enemyPlayer.getNextNuclearStrikeTickIndex() != -1 ? enemyPlayer.getNextNuclearStrikeTickIndex() - state.world()->getTickIndex() : 0;
+
+    const double nukeRadius        = state.game()->getTacticalNuclearStrikeRadius();
+    const double maxPossibleDamage = state.game()->getMaxTacticalNuclearStrikeDamage();
+    const int    strikeDelay       = state.game()->getTacticalNuclearStrikeDelay();
+
+    NukeDamageGrid damageGrid(allVehicles, nukeRadius, maxPossibleDamage, -1.5);
+
+    const VehicleGrid& grid = state.vehicleGrid();
+
+    for (Slot slot = 0; slot < allVehicles.size(); ++slot)
+        if (allVehicles.isAlive(slot) && allVehicles.isMine(slot))
+            teammates.push_back(slot);
+
+    // units keep moving while the missile flies, so damage is evaluated at positions extrapolated to detonation.
+    // Hit points are within reachable rect, so only units within strike radius of it may be hurt. All of them are
+    // counted, so cached damage of a hit point doesn't depend on where the rect is
+    const Rect   damageRect = reachableRect.inflate(nukeRadius);
+    const double maxTravel  = strikeDelay * state.game()->getFighterSpeed();   // fighters are the fastest
+
+    std::vector<Slot>  damageUnits;
+    std::vector<Point> damagePositions;
+    std::vector<Slot>  hitSlots;          // reachable enemies, strike is aimed at their predicted positions
+
+    grid.forEachInRect(damageRect.inflate(maxTravel), VehicleGrid::Filter::any(), [&](Slot unit)
+    {
+        const Point predicted = state.predictVehiclePosition(unit, strikeDelay);
+
+        m_predicted[unit]     = predicted;
+        m_hasPrediction[unit] = true;
+
+        if (!damageRect.contains(predicted))
+            return;
+
+        damageUnits.push_back(unit);
+        damagePositions.push_back(predicted);
+
+        if (!allVehicles.isMine(unit) && reachableRect.contains(predicted))
+            hitSlots.push_back(unit);
+    });
+
+    damageGrid.build(damageRect, damageUnits, damagePositions);
+
+    // unit positions only, or also the best points of dense damage raster
+    enum class NukeAiming { eUNIT_POSITIONS, eDENSE };
+    static const NukeAiming AIMING_MODE      = NukeAiming::eDENSE;
+    static const size_t     DENSE_CANDIDATES = 4;     // re-scored exactly per guide
+
+    NukeDamageTable damageTable(allVehicles, nukeRadius, maxPossibleDamage, -1.5);
+    std::vector<Point> denseCandidates;
+
+    if (AIMING_MODE == NukeAiming::eDENSE)
+    {
+        const Rect worldRect(Point(0, 0), Point(state.game()->getWorldWidth(), state.game()->getWorldHeight()));
+
+        Rect hitArea;
+        if (reachableRect.overlaps(worldRect, hitArea))
+            damageTable.build(damageRect, hitArea, damageUnits, damagePositions);
+    }
+
+    static const double MIN_HEALTH = 0.5 * 100;    // TODO - remove hardcode
+    static const double MIN_DAMAGE = 90;
+
+    auto getEnemyNukeDamage = [&](Slot teammate)
+    {
+        if (enemyNuke == Point())
+            return 0.0;
+
+        const Point position = state.predictVehiclePosition(teammate, ticksToEnemyNuke);
+        return damageGrid.unitDamage(enemyNuke, position, false) + ticksToEnemyNuke / 2;
+    };
+
+    // guides by damage of enemies they see, DESC. Ties are kept, unlike keys of a map
+    std::vector<std::pair<double, Slot>> guides;
+
+    for (Slot teammate : teammates)
+    {
+        const double healthThreshold = std::max(MIN_HEALTH, getEnemyNukeDamage(teammate));
+        if (allVehicles.durability(teammate) <= healthThreshold)
+            continue;   // teammate is about to go :(
+
+        double damage = 0;
+        double sqaredVr = allVehicles.vehicle(teammate).getSquaredVisionRange();
+        const Point teammatePoint = allVehicles.point(teammate);
+
+        grid.forEachInRadius(teammatePoint, std::sqrt(sqaredVr), VehicleGrid::Filter::enemy(),
+            [&](Slot enemy)
+        {
+            if (reachableRect.contains(allVehicles.point(enemy)) && teammatePoint.getSquareDistance(allVehicles.point(enemy)) < sqaredVr)
+                damage += allVehicles.durability(enemy) * (allVehicles.durability(enemy) > MIN_HEALTH ? 1 : 2);
+        });
+
+        if (damage >= MIN_DAMAGE)
+            guides.emplace_back(damage, teammate);
+    }
+
+    std::stable_sort(guides.begin(), guides.end(), [](const std::pair<double, Slot>& a, const std::pair<double, Slot>& b) { return a.first > b.first; });
+
+    static const size_t LOOKUP_ITEMS_LIMIT = 50;
+    if (guides.size() > LOOKUP_ITEMS_LIMIT)
+        guides.resize(LOOKUP_ITEMS_LIMIT);
+
+    std::vector<Target> targets;
+    targets.reserve(guides.size());
+
+    for (const auto& damageGuidePair : guides)
+    {
+        Slot teammate = damageGuidePair.second;
+        const model::Vehicle& guide = allVehicles.vehicle(teammate);
+        const Point teammatePoint   = allVehicles.point(teammate);
+        const Point guideAtStrike   = state.predictVehiclePosition(teammate, strikeDelay);
+
+        Target bestDamage;
+        bestDamage.m_guide = teammate;
+
+        // target should be visible both at launch and at detonation, when guide moved and terrain/weather may differ
+
+        double rangeGap = allVehicles.radius(teammate);
+        double visionRange = state.getUnitVisionRange(guide) - 2 * allVehicles.radius(teammate) - rangeGap;
+        double squaredVR = visionRange * visionRange;
+
+        double visionRangeAtStrike = state.getUnitVisionRangeAt(guide, guideAtStrike) - 2 * allVehicles.radius(teammate) - rangeGap;
+        double squaredVRAtStrike   = visionRangeAtStrike * visionRangeAtStrike;
+
+        const double guideHealth = allVehicles.durability(teammate) - getEnemyNukeDamage(teammate);
+
+        auto canGuide = [&](const Point& hitPoint)
+        {
+            return teammatePoint.getSquareDistance(hitPoint) <= squaredVR
+                && guideAtStrike.getSquareDistance(hitPoint) <= squaredVRAtStrike
+                && guideHealth > damageGrid.unitDamage(hitPoint, guideAtStrike, false);   // guide survives own strike
+        };
+
+        for (Slot hitSlot : hitSlots)
+        {
+            const Point& hitPoint = m_predicted[hitSlot];
+            if (!canGuide(hitPoint))
+                continue;
+
+            // the same hit point is checked for many guides and ticks, its damage is computed once
+            if (m_hitDamage[hitSlot] == UNKNOWN_DAMAGE)
+                m_hitDamage[hitSlot] = damageGrid.damageAt(hitPoint);
+
+            const double damage = m_hitDamage[hitSlot];
+
+            if (bestDamage.m_damage < damage)
+            {
+                bestDamage.m_damage = damage;
+                bestDamage.m_point = hitPoint;
+            }
+        }
+
+        if (AIMING_MODE == NukeAiming::eDENSE)
+        {
+            damageTable.bestPoints(teammatePoint, visionRange, DENSE_CANDIDATES, denseCandidates);
+
+            for (const Point& hitPoint : denseCandidates)
+            {
+                if (!canGuide(hitPoint))
+                    continue;
+
+                const double damage = damageGrid.damageAt(hitPoint);
+                if (bestDamage.m_damage < damage)
+                {
+                    bestDamage.m_damage = damage;
+                    bestDamage.m_point = hitPoint;
+                }
+            }
+        }
+
+        if (bestDamage.m_damage > 0)
+            targets.emplace_back(bestDamage);
+    }
+
+    // pre-sort DESC by guide durability
+    std::sort(targets.begin(), targets.end(), [&allVehicles](const Target& a, const Target& b) { return allVehicles.durability(a.m_guide) > allVehicles.durability(b.m_guide); });
+
+    // sort DESC by damage
+    std::stable_sort(targets.begin(), targets.end(), [](const Target& a, const Target& b) { return a.m_damage > b.m_damage; });
+
+    if (!targets.empty())
+    {
+        m_best      = targets.front();
+        m_hasTarget = true;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+
+#include "geometry.h"
+#include "VehicleStore.h"
+
+class State;
+
+// Chooses nuclear strike target and guide. Updated by State once per tick, goals only read the result.
+// Works only while strike is ready. Target selection is a full pass: damage grid and table are rebuilt and
+// every guide is checked against every hit point. Only damage of unit hit points is cached, it's invalidated
+// around units which moved, appeared or died since previous tick. The pass is skipped only when nothing changed,
+// which in a fight means it runs almost every tick.
+class NukePlanner
+{
+public:
+    typedef VehicleStore::Slot Slot;
+
+    struct Target
+    {
+        Point  m_point;
+        Slot   m_guide  = VehicleStore::INVALID_SLOT;
+        double m_damage = 0;
+    };
+
+    // changed are slots updated, added or killed since previous call
+    void update(const State& state, const std::vector<Slot>& changed);
+
+    bool          hasTarget() const     { return m_hasTarget; }
+    const Target& bestTarget() const    { return m_best; }
+
+private:
+    void reset();
+    void invalidate(const State& state, const std::vector<Slot>& changed);
+    void invalidateAround(const State& state, const Point& point);
+    void evaluate(const State& state);
+
+    Target              m_best;
+    bool                m_hasTarget = false;
+    bool                m_isWarm    = false;    // caches below match current positions
+    int                 m_enemyStrikeTick = -1; // enemy strike the best target was chosen with
+
+    std::vector<Slot>   m_previousChanged;      // units moved last tick may have stopped now, so their predictions changed too
+    std::vector<double> m_hitDamage;            // by enemy slot, damage of strike at its predicted position
+    std::vector<Point>  m_predicted;            // by slot, position cached damages were computed with
+    std::vector<bool>   m_hasPrediction;        // by slot
+};
@@ -0,0 +1,78 @@
+#include "PathQueryCache.h"
+#include <cmath>
+#include <functional>
+
+const double PathQueryCache::BUCKET = 0.1;
+
+static int32_t toBucket(double value)
+{
+    return static_cast<int32_t>(std::floor(value / PathQueryCache::BUCKET));
+}
+
+bool PathQueryCache::Key::operator==(const Key& right) const
+{
+    return m_moverUnits == right.m_moverUnits && m_obstacleUnits == right.m_obstacleUnits
+        && m_moverCount == right.m_moverCount && m_obstacleCount == right.m_obstacleCount
+        && m_moverX    == right.m_moverX    && m_moverY    == right.m_moverY
+        && m_obstacleX == right.m_obstacleX && m_obstacleY == right.m_obstacleY
+        && m_toX       == right.m_toX       && m_toY       == right.m_toY;
+}
+
+size_t PathQueryCache::KeyHash::operator()(const Key& key) const
+{
+    // http://stackoverflow.com/a/1646913/126995
+    size_t res = 17;
+    res = res * 31 + std::hash<uint64_t>()(key.m_moverUnits);
+    res = res * 31 + std::hash<uint64_t>()(key.m_obstacleUnits);
+    res = res * 31 + key.m_moverCount;
+    res = res * 31 + key.m_obstacleCount;
+    res = res * 31 + static_cast<uint32_t>(key.m_moverX);
+    res = res * 31 + static_cast<uint32_t>(key.m_moverY);
+    res = res * 31 + static_cast<uint32_t>(key.m_obstacleX);
+    res = res * 31 + static_cast<uint32_t>(key.m_obstacleY);
+    res = res * 31 + static_cast<uint32_t>(key.m_toX);
+    res = res * 31 + static_cast<uint32_t>(key.m_toY);
+    return res;
+}
+
+uint64_t PathQueryCache::unitsHash(const VehicleGroup& group)
+{
+    // FNV-1a over the slots, then a final mix. Collisions within one tick are not realistic
+    uint64_t res = 14695981039346656037ull;
+    for (VehicleStore::Slot slot : group.m_units)
+    {
+        res ^= slot;
+        res *= 1099511628211ull;
+    }
+
+    res ^= res >> 33;
+    res *= 0xff51afd7ed558ccdull;
+    res ^= res >> 33;
+    return res;
+}
+
+PathQueryCache::Key PathQueryCache::makeKey(const VehicleGroup& mover, const Point& moverCenter, const Point& to, const VehicleGroup& obstacle, const Point& obstacleCenter)
+{
+    Key key;
+    key.m_moverUnits    = unitsHash(mover);
+    key.m_obstacleUnits = unitsHash(obstacle);
+    key.m_moverCount    = static_cast<uint32_t>(mover.unitsCount());
+    key.m_obstacleCount = static_cast<uint32_t>(obstacle.unitsCount());
+    key.m_moverX        = toBucket(moverCenter.m_x);
+    key.m_moverY        = toBucket(moverCenter.m_y);
+    key.m_obstacleX     = toBucket(obstacleCenter.m_x);
+    key.m_obstacleY     = toBucket(obstacleCenter.m_y);
+    key.m_toX           = toBucket(to.m_x);
+    key.m_toY           = toBucket(to.m_y);
+    return key;
+}
+
+bool PathQueryCache::find(const Key& key, bool& result) const
+{
+    auto found = m_results.find(key);
+    if (found == m_results.end())
+        return false;
+
+    result = found->second;
+    return true;
+}
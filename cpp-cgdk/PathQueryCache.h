@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+#include "geometry.h"
+#include "VehicleGroup.h"
+
+// Results of isPathFree() asked during the current tick. Goals ask nearly the same questions many times,
+// so a query is keyed by the unit slots of both groups and positions rounded to BUCKET. Slots identify
+// a group by content, so temporary groups which reuse a stack address don't get each other's answers.
+// Cleared by State when a tick starts and whenever groups are rebuilt.
+class PathQueryCache
+{
+public:
+    static const double BUCKET;
+
+    void clear()                      { m_results.clear(); }
+
+    // mover and obstacle are VehicleGroup or VehicleGroupGhost
+    template <typename Mover, typename Obstacle>
+    bool isPathFree(const Mover& mover, const Point& to, const Obstacle& obstacle)
+    {
+        const Key key = makeKey(original(mover), mover.m_center, to, original(obstacle), obstacle.m_center);
+
+        bool result = false;
+        if (find(key, result))
+            return result;
+
+        result = mover.isPathFree(to, obstacle);
+        m_results.emplace(key, result);
+        return result;
+    }
+
+private:
+    struct Key
+    {
+        uint64_t m_moverUnits;          // hash of unit slots
+        uint64_t m_obstacleUnits;
+        uint32_t m_moverCount;
+        uint32_t m_obstacleCount;
+        int32_t  m_moverX,    m_moverY;
+        int32_t  m_obstacleX, m_obstacleY;
+        int32_t  m_toX,       m_toY;
+
+        bool operator==(const Key& right) const;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    static const VehicleGroup& original(const VehicleGroup& group)       { return group; }
+    static const VehicleGroup& original(const VehicleGroupGhost& ghost)  { return ghost.m_original; }
+
+    static uint64_t unitsHash(const VehicleGroup& group);
+    static Key makeKey(const VehicleGroup& mover, const Point& moverCenter, const Point& to, const VehicleGroup& obstacle, const Point& obstacleCenter);
+
+    bool find(const Key& key, bool& result) const;
+
+    std::unordered_map<Key, bool, KeyHash> m_results;
+};
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 
 using namespace model;
@@ -12,36 +13,91 @@ const int INTEGER_SIZE_BYTES = sizeof(int);
 const int LONG_SIZE_BYTES = sizeof(long long);
 
 constexpr size_t MAX_BUFFER_SIZE = 1024 * 1024;
+constexpr size_t WRITE_BUFFER_SIZE = 4 * 1024;
 
-ReadBuffer::ReadBuffer(CActiveSocket &socket) : socket(socket) {
-    buf.reserve(MAX_BUFFER_SIZE);
-    pos = 0;
+ReadBuffer::ReadBuffer(CActiveSocket &socket)
+    : buf(new signed char[MAX_BUFFER_SIZE]), pos(0), len(0), consumed(0), socket(socket), capture(nullptr) {
+}
+
+ReadBuffer::~ReadBuffer() {
+    if (capture != nullptr) {
+        fclose(capture);
+    }
+}
+
+bool ReadBuffer::startCapture(const std::string& path) {
+    if (capture != nullptr) {
+        fclose(capture);
+    }
+
+    capture = fopen(path.c_str(), "wb");
+    return capture != nullptr;
+}
+
+bool ReadBuffer::startReplay(const std::string& path) {
+    std::unique_ptr<MappedFile> file(new MappedFile);
+    if (!file->open(path)) {
+        return false;
+    }
+
+    replay = std::move(file);
+    buf.reset();
+    pos = len = 0;
+    return true;
+}
+
+bool ReadBuffer::isReplay() const {
+    return replay != nullptr;
+}
+
+size_t ReadBuffer::getConsumedByteCount() const {
+    return consumed;
 }
 
 signed char* ReadBuffer::read(unsigned int byteCount) {
+    if (replay != nullptr) {
+        if (replay->getSize() - pos < byteCount) {
+            exit(10012);
+        }
+
+        signed char* result = replay->getData() + pos;
+        pos += byteCount;
+        consumed += byteCount;
+        return result;
+    }
+
     if (byteCount > MAX_BUFFER_SIZE) {
         /* Invalid MAX_BUFFER_SIZE or byteCount */
         exit(11111);
     }
-    
-    int32 receivedByteCount;
-    
-    do {
-        if (buf.size() - pos >= byteCount) {
-            signed char* result = buf.data() + pos;
-            pos += byteCount;
-            return result;
+
+    while (len - pos < byteCount) {
+        // move the unread tail to the front only when the request does not fit into the free space
+        if (pos == len) {
+            pos = len = 0;
+        } else if (MAX_BUFFER_SIZE - pos < byteCount) {
+            memmove(buf.get(), buf.get() + pos, len - pos);
+            len -= pos;
+            pos = 0;
         }
-        
-        buf.erase(buf.begin(), buf.begin() + pos);
-        pos = 0;
-        
-        receivedByteCount = socket.Receive(MAX_BUFFER_SIZE - buf.size());
-        if (receivedByteCount > 0)
-            buf.insert(buf.end(), socket.GetData(), socket.GetData() + receivedByteCount);
-    } while (receivedByteCount > 0);
-    
-    exit(10012);
+
+        int32 receivedByteCount = socket.Receive(static_cast<int32>(MAX_BUFFER_SIZE - len),
+                                                 reinterpret_cast<uint8*>(buf.get() + len));
+        if (receivedByteCount <= 0) {
+            exit(10012);
+        }
+
+        if (capture != nullptr) {
+            fwrite(buf.get() + len, 1, receivedByteCount, capture);
+        }
+
+        len += receivedByteCount;
+    }
+
+    signed char* result = buf.get() + pos;
+    pos += byteCount;
+    consumed += byteCount;
+    return result;
 }
 
 std::vector<signed char> ReadBuffer::readToVector(unsigned int byteCount) {
@@ -50,10 +106,44 @@ std::vector<signed char> ReadBuffer::readToVector(unsigned int byteCount) {
     return result;
 }
 
+WriteBuffer::WriteBuffer(CActiveSocket &socket) : socket(socket), discard(false) {
+    buf.reserve(WRITE_BUFFER_SIZE);
+}
+
+void WriteBuffer::setDiscard(bool discard) {
+    this->discard = discard;
+}
+
+void WriteBuffer::write(const signed char* bytes, unsigned int byteCount) {
+    buf.insert(buf.end(), bytes, bytes + byteCount);
+}
+
+void WriteBuffer::flush() {
+    if (discard) {
+        buf.clear();
+        return;
+    }
+
+    size_t byteCount = buf.size();
+    size_t offset = 0;
+    int sentByteCount;
+
+    while (offset < byteCount && (sentByteCount = socket.Send(reinterpret_cast<const uint8*>(&buf[offset]), byteCount - offset)) > 0) {
+        offset += sentByteCount;
+    }
+
+    if (offset != byteCount) {
+        exit(10013);
+    }
+
+    buf.clear();
+}
+
 RemoteProcessClient::RemoteProcessClient(string host, int port)
-    : buffer(socket), cachedBoolFlag(false), cachedBoolValue(false), previousPlayers(vector<Player> ()),
-    previousFacilities(vector<Facility> ()), terrainByCellXY(vector<vector<TerrainType> > ()),
-    weatherByCellXY(vector<vector<WeatherType> > ()), previousPlayerById(unordered_map<long long, Player> ()),
+    : buffer(socket), writeBuffer(socket), cachedBoolFlag(false), cachedBoolValue(false), vehicleUpdateSink(nullptr),
+    previousPlayers(vector<Player> ()),
+    previousFacilities(vector<Facility> ()), terrainByCellXY(nullptr),
+    weatherByCellXY(nullptr), previousPlayerById(unordered_map<long long, Player> ()),
     previousFacilityById(unordered_map<long long, Facility>()){
     socket.Initialize();
     socket.DisableNagleAlgoritm();
@@ -63,14 +153,26 @@ RemoteProcessClient::RemoteProcessClient(string host, int port)
     }
 }
 
+RemoteProcessClient::RemoteProcessClient(const string& replayPath)
+    : buffer(socket), writeBuffer(socket), cachedBoolFlag(false), cachedBoolValue(false), vehicleUpdateSink(nullptr),
+    terrainByCellXY(nullptr), weatherByCellXY(nullptr) {
+    if (!buffer.startReplay(replayPath)) {
+        exit(10002);
+    }
+
+    writeBuffer.setDiscard(true);
+}
+
 void RemoteProcessClient::writeTokenMessage(const string& token) {
     writeEnum<MessageType>(MessageType::AUTHENTICATION_TOKEN);
     writeString(token);
+    writeBuffer.flush();
 }
 
 void RemoteProcessClient::writeProtocolVersionMessage() {
     writeEnum<MessageType>(MessageType::PROTOCOL_VERSION);
     writeInt(3);
+    writeBuffer.flush();
 }
 
 void RemoteProcessClient::readTeamSizeMessage() {
@@ -104,10 +206,27 @@ shared_ptr<PlayerContext> RemoteProcessClient::readPlayerContextMessage() {
 void RemoteProcessClient::writeMoveMessage(const Move& move) {
     writeEnum<MessageType>(MessageType::MOVE);
     writeMove(move);
+    writeBuffer.flush();
+}
+
+void RemoteProcessClient::setVehicleUpdateSink(VehicleUpdateSink* sink) {
+    vehicleUpdateSink = sink;
+}
+
+void RemoteProcessClient::startCapture(const string& capturePath) {
+    if (!buffer.startCapture(capturePath)) {
+        exit(10003);
+    }
+}
+
+size_t RemoteProcessClient::getConsumedByteCount() const {
+    return buffer.getConsumedByteCount();
 }
 
 void RemoteProcessClient::close() {
-    socket.Close();
+    if (!buffer.isReplay()) {
+        socket.Close();
+    }
 }
 
 Facility RemoteProcessClient::readFacility() {
@@ -687,6 +806,12 @@ vector<VehicleUpdate> RemoteProcessClient::readVehicleUpdates() {
     }
 
     vector<VehicleUpdate> vehicleUpdates;
+
+    if (vehicleUpdateSink != nullptr) {
+        readVehicleUpdatesToSink(vehicleUpdateCount);
+        return vehicleUpdates;
+    }
+
     vehicleUpdates.reserve(vehicleUpdateCount);
 
     for (int vehicleUpdateIndex = 0; vehicleUpdateIndex < vehicleUpdateCount; ++vehicleUpdateIndex) {
@@ -696,6 +821,25 @@ vector<VehicleUpdate> RemoteProcessClient::readVehicleUpdates() {
     return vehicleUpdates;
 }
 
+void RemoteProcessClient::readVehicleUpdatesToSink(int vehicleUpdateCount) {
+    for (int vehicleUpdateIndex = 0; vehicleUpdateIndex < vehicleUpdateCount; ++vehicleUpdateIndex) {
+        if (!readBoolean()) {
+            exit(20013);
+        }
+
+        long long id = readLong();
+        double x = readDouble();
+        double y = readDouble();
+        int durability = readInt();
+        int remainingAttackCooldownTicks = readInt();
+        bool selected = readBoolean();
+        readIntArray(vehicleUpdateGroups);
+
+        vehicleUpdateSink->applyVehicleUpdate(id, x, y, durability, remainingAttackCooldownTicks, selected,
+            vehicleUpdateGroups);
+    }
+}
+
 void RemoteProcessClient::writeVehicleUpdates(const vector<VehicleUpdate>& vehicleUpdates) {
     int vehicleUpdateCount = vehicleUpdates.size();
     writeInt(vehicleUpdateCount);
@@ -718,12 +862,12 @@ World RemoteProcessClient::readWorld() {
     vector<Vehicle> newVehicles = readVehicles();
     vector<VehicleUpdate> vehicleUpdates = readVehicleUpdates();
 
-    if (terrainByCellXY.empty()) {
-        terrainByCellXY = readEnumArray2D<TerrainType>();
+    if (terrainByCellXY == nullptr) {
+        terrainByCellXY = make_shared<const TerrainGrid>(readEnumArray2D<TerrainType>());
     }
 
-    if (weatherByCellXY.empty()) {
-        weatherByCellXY = readEnumArray2D<WeatherType>();
+    if (weatherByCellXY == nullptr) {
+        weatherByCellXY = make_shared<const WeatherGrid>(readEnumArray2D<WeatherType>());
     }
 
     vector<Facility> facilities = readFacilities();
@@ -742,8 +886,8 @@ void RemoteProcessClient::writeWorld(const World& world) {
     writePlayers(world.getPlayers());
     writeVehicles(world.getNewVehicles());
     writeVehicleUpdates(world.getVehicleUpdates());
-    writeEnumArray2D<TerrainType>(world.getTerrainByCellXY());
-    writeEnumArray2D<WeatherType>(world.getWeatherByCellXY());
+    writeEnumGrid<TerrainType>(*world.getTerrainByCellXY());
+    writeEnumGrid<WeatherType>(*world.getWeatherByCellXY());
     writeFacilities(world.getFacilities());
 }
 
@@ -838,9 +982,7 @@ template <typename E> vector<vector<E> > RemoteProcessClient::readEnumArray2D()
 }
 
 template <typename E> void RemoteProcessClient::writeEnum(E value) {
-    vector<signed char> bytes;
-    bytes.push_back(static_cast<signed char>(value));
-    this->writeBytes(bytes);
+    this->writeByte(static_cast<signed char>(value));
 }
 
 template <typename E> void RemoteProcessClient::writeEnumArray(const vector<E>& value) {
@@ -861,6 +1003,20 @@ template <typename E> void RemoteProcessClient::writeEnumArray2D(const vector<ve
     }
 }
 
+template <typename E> void RemoteProcessClient::writeEnumGrid(const CellGrid<E>& value) {
+    int width = value.getWidth();
+    int height = value.getHeight();
+    writeInt(width);
+
+    for (int x = 0; x < width; ++x) {
+        writeInt(height);
+
+        for (int y = 0; y < height; ++y) {
+            writeEnum<E>(value.get(x, y));
+        }
+    }
+}
+
 string RemoteProcessClient::readString() {
     int length = this->readInt();
     if (length == -1) {
@@ -871,8 +1027,8 @@ string RemoteProcessClient::readString() {
         return "";
     }
 
-    vector<signed char> bytes = this->readBytes(length);
-    return string(reinterpret_cast<char*>(&bytes[0]), length);
+    const signed char* bytes = buffer.read(length);
+    return string(reinterpret_cast<const char*>(bytes), length);
 }
 
 void RemoteProcessClient::writeString(const string& value) {
@@ -882,12 +1038,8 @@ void RemoteProcessClient::writeString(const string& value) {
         return;
     }
 
-    vector<signed char> bytes(length);
-
-    memcpy(&bytes[0], value.c_str(), length);
-
-    this->writeInt(static_cast<int>(bytes.size()));
-    this->writeBytes(bytes);
+    this->writeInt(static_cast<int>(length));
+    writeBuffer.write(reinterpret_cast<const signed char*>(value.c_str()), static_cast<unsigned int>(length));
 }
 
 bool RemoteProcessClient::readBoolean() {
@@ -930,6 +1082,19 @@ vector<int> RemoteProcessClient::readIntArray() {
     return value;
 }
 
+void RemoteProcessClient::readIntArray(vector<int>& value) {
+    int length = readInt();
+    if (length < 0) {
+        exit(10018);
+    }
+
+    value.resize(length);
+
+    for (int i = 0; i < length; ++i) {
+        value[i] = readInt();
+    }
+}
+
 vector<vector<int> > RemoteProcessClient::readIntArray2D() {
     int length = readInt();
     if (length < 0) {
@@ -956,15 +1121,15 @@ vector<vector<int> > RemoteProcessClient::readIntArray2D() {
 }
 
 void RemoteProcessClient::writeInt(int value) {
-    vector<signed char> bytes(INTEGER_SIZE_BYTES);
+    signed char bytes[INTEGER_SIZE_BYTES];
 
-    memcpy(&bytes[0], &value, INTEGER_SIZE_BYTES);
+    memcpy(bytes, &value, INTEGER_SIZE_BYTES);
 
     if (this->isLittleEndianMachine() != LITTLE_ENDIAN_BYTE_ORDER) {
-        reverse(bytes.begin(), bytes.end());
+        reverse(bytes, bytes + INTEGER_SIZE_BYTES);
     }
 
-    this->writeBytes(bytes);
+    writeBuffer.write(bytes, INTEGER_SIZE_BYTES);
 }
 
 void RemoteProcessClient::writeIntArray(const vector<int>& value) {
@@ -998,15 +1163,15 @@ long long RemoteProcessClient::readLong() {
 }
 
 void RemoteProcessClient::writeLong(long long value) {
-    vector<signed char> bytes(LONG_SIZE_BYTES);
+    signed char bytes[LONG_SIZE_BYTES];
 
-    memcpy(&bytes[0], &value, LONG_SIZE_BYTES);
+    memcpy(bytes, &value, LONG_SIZE_BYTES);
 
     if (this->isLittleEndianMachine() != LITTLE_ENDIAN_BYTE_ORDER) {
-        reverse(bytes.begin(), bytes.end());
+        reverse(bytes, bytes + LONG_SIZE_BYTES);
     }
 
-    this->writeBytes(bytes);
+    writeBuffer.write(bytes, LONG_SIZE_BYTES);
 }
 
 double RemoteProcessClient::readDouble() {
@@ -1018,26 +1183,6 @@ void RemoteProcessClient::writeDouble(double value) {
     this->writeLong(*reinterpret_cast<long long*>(&value));
 }
 
-void RemoteProcessClient::writeByte(signed char value) {
-    if (socket.Send(reinterpret_cast<const uint8*>(&value), 1) != 1) {
-        exit(10022);
-    }
-}
-
-void RemoteProcessClient::writeBytes(const vector<signed char>& bytes) {
-    vector<signed char>::size_type byteCount = bytes.size();
-    unsigned int offset = 0;
-    int sentByteCount;
-
-    while (offset < byteCount && (sentByteCount = socket.Send(reinterpret_cast<const uint8*>(&bytes[offset]), byteCount - offset)) > 0) {
-        offset += sentByteCount;
-    }
-
-    if (offset != byteCount) {
-        exit(10013);
-    }
-}
-
 bool RemoteProcessClient::isLittleEndianMachine() {
     union {
         uint16 value;
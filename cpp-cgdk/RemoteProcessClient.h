@@ -3,16 +3,19 @@
 #ifndef _REMOTE_PROCESS_CLIENT_H_
 #define _REMOTE_PROCESS_CLIENT_H_
 
+#include <cstdio>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "csimplesocket/ActiveSocket.h"
+#include "MappedFile.h"
 #include "model/Game.h"
 #include "model/Move.h"
 #include "model/PlayerContext.h"
 #include "model/World.h"
+#include "VehicleUpdateSink.h"
 
 enum class MessageType {
     UNKNOWN,
@@ -28,24 +31,52 @@ enum class MessageType {
 class ReadBuffer {
 public:
     explicit ReadBuffer(CActiveSocket &socket);
+    ~ReadBuffer();
     signed char* read(unsigned int byteCount);
     std::vector<signed char> readToVector(unsigned int byteCount);
+
+    /* Tee every received byte into the file */
+    bool startCapture(const std::string& path);
+    /* Serve reads from the previously captured file instead of the socket */
+    bool startReplay(const std::string& path);
+    bool isReplay() const;
+    size_t getConsumedByteCount() const;
 private:
-    std::vector<signed char> buf;
+    std::unique_ptr<signed char[]> buf;
     size_t pos;
+    size_t len;
+    size_t consumed;
+    CActiveSocket &socket;
+    std::FILE* capture;
+    std::unique_ptr<MappedFile> replay;
+};
+
+class WriteBuffer {
+public:
+    explicit WriteBuffer(CActiveSocket &socket);
+    void write(const signed char* bytes, unsigned int byteCount);
+    void flush();
+    void setDiscard(bool discard);
+private:
+    std::vector<signed char> buf;
     CActiveSocket &socket;
+    bool discard;
 };
 
 class RemoteProcessClient {
     CActiveSocket socket;
     ReadBuffer buffer;
+    WriteBuffer writeBuffer;
     bool cachedBoolFlag;
     bool cachedBoolValue;
 
+    VehicleUpdateSink* vehicleUpdateSink;
+    std::vector<int> vehicleUpdateGroups;
+
     std::vector<model::Player> previousPlayers;
     std::vector<model::Facility> previousFacilities;
-    std::vector<std::vector<model::TerrainType> > terrainByCellXY;
-    std::vector<std::vector<model::WeatherType> > weatherByCellXY;
+    model::TerrainGridPtr terrainByCellXY;
+    model::WeatherGridPtr weatherByCellXY;
 
     std::unordered_map<long long, model::Player> previousPlayerById;
     std::unordered_map<long long, model::Facility> previousFacilityById;
@@ -75,6 +106,7 @@ class RemoteProcessClient {
     model::VehicleUpdate readVehicleUpdate();
     void writeVehicleUpdate(const model::VehicleUpdate& vehicleUpdate);
     std::vector<model::VehicleUpdate> readVehicleUpdates();
+    void readVehicleUpdatesToSink(int vehicleUpdateCount);
     void writeVehicleUpdates(const std::vector<model::VehicleUpdate>& vehicleUpdates);
     model::World readWorld();
     void writeWorld(const model::World& world);
@@ -92,6 +124,7 @@ class RemoteProcessClient {
     template <typename E> void writeEnum(E value);
     template <typename E> void writeEnumArray(const std::vector<E>& value);
     template <typename E> void writeEnumArray2D(const std::vector<std::vector<E> >& value);
+    template <typename E> void writeEnumGrid(const model::CellGrid<E>& value);
 
     std::string readString();
     void writeString(const std::string& value);
@@ -101,6 +134,7 @@ class RemoteProcessClient {
 
     int readInt();
     std::vector<int> readIntArray();
+    void readIntArray(std::vector<int>& value);
     std::vector<std::vector<int> > readIntArray2D();
     void writeInt(int value);
     void writeIntArray(const std::vector<int>& value);
@@ -119,12 +153,23 @@ class RemoteProcessClient {
     std::vector<signed char> readBytes(unsigned int byteCount) {
         return buffer.readToVector(byteCount);
     }
-    void writeByte(signed char value);
-    void writeBytes(const std::vector<signed char>& bytes);
+
+    void writeByte(signed char value) {
+        writeBuffer.write(&value, 1);
+    }
+
+    void writeBytes(const std::vector<signed char>& bytes) {
+        writeBuffer.write(bytes.data(), static_cast<unsigned int>(bytes.size()));
+    }
 
     static bool isLittleEndianMachine();
 public:
     RemoteProcessClient(std::string host, int port);
+    /* Replays the session captured by startCapture(), writes are discarded */
+    explicit RemoteProcessClient(const std::string& replayPath);
+
+    void startCapture(const std::string& capturePath);
+    size_t getConsumedByteCount() const;
 
     void writeTokenMessage(const std::string& token);
     void writeProtocolVersionMessage();
@@ -133,6 +178,8 @@ public:
     std::shared_ptr<model::PlayerContext> readPlayerContextMessage();
     void writeMoveMessage(const model::Move& move);
 
+    void setVehicleUpdateSink(VehicleUpdateSink* sink);
+
     void close();
 
     ~RemoteProcessClient();
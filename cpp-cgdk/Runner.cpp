@@ -1,5 +1,8 @@
 #include "Runner.h"
 
+#include <chrono>
+#include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include "MyStrategy.h"
@@ -8,7 +11,13 @@ using namespace model;
 using namespace std;
 
 int main(int argc, char* argv[]) {
-    if (argc == 4) {
+    if (argc == 3 && strcmp(argv[1], "--replay") == 0) {
+        Runner runner(argv[2]);
+        runner.run();
+    } else if (argc == 5) {
+        Runner runner(argv[1], argv[2], argv[3], argv[4]);
+        runner.run();
+    } else if (argc == 4) {
         Runner runner(argv[1], argv[2], argv[3]);
         runner.run();
     } else {
@@ -20,16 +29,29 @@ int main(int argc, char* argv[]) {
 }
 
 Runner::Runner(const char* host, const char* port, const char* token)
-    : remoteProcessClient(host, atoi(port)), token(token) {
+    : remoteProcessClient(host, atoi(port)), token(token), replay(false) {
+}
+
+Runner::Runner(const char* host, const char* port, const char* token, const char* capturePath)
+    : remoteProcessClient(host, atoi(port)), token(token), replay(false) {
+    remoteProcessClient.startCapture(capturePath);
+}
+
+Runner::Runner(const char* replayPath)
+    : remoteProcessClient(std::string(replayPath)), token("0000000000000000"), replay(true) {
 }
 
 void Runner::run() {
+    auto startTime = chrono::steady_clock::now();
+    int tickCount = 0;
+
     remoteProcessClient.writeTokenMessage(token);
     remoteProcessClient.writeProtocolVersionMessage();
     remoteProcessClient.readTeamSizeMessage();
     Game game = remoteProcessClient.readGameContextMessage();
 
     unique_ptr<Strategy> strategy(new MyStrategy);
+    remoteProcessClient.setVehicleUpdateSink(strategy->getVehicleUpdateSink());
 
     shared_ptr<PlayerContext> playerContext;
 
@@ -40,5 +62,12 @@ void Runner::run() {
         strategy->move(player, playerContext->getWorld(), game, move);
 
         remoteProcessClient.writeMoveMessage(move);
+        ++tickCount;
+    }
+
+    if (replay) {
+        auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime);
+        printf("replayed %d ticks (%zu bytes) in %lld ms\n", tickCount, remoteProcessClient.getConsumedByteCount(),
+            static_cast<long long>(elapsed.count()));
     }
 }
@@ -11,8 +11,11 @@ class Runner {
 private:
     RemoteProcessClient remoteProcessClient;
     std::string token;
+    bool replay;
 public:
     Runner(const char*, const char*, const char*);
+    Runner(const char*, const char*, const char*, const char*);
+    explicit Runner(const char*);
 
     void run();
 };
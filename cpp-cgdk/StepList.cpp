@@ -0,0 +1,84 @@
+#include "StepList.h"
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+    typedef std::aligned_storage<sizeof(GoalStep), alignof(GoalStep)>::type NodeStorage;
+
+    // free nodes are linked through their first bytes
+    struct FreeNode
+    {
+        FreeNode* m_next;
+    };
+
+    static_assert(sizeof(NodeStorage) >= sizeof(FreeNode), "node is too small for free list link");
+
+    struct StepPool
+    {
+        static const size_t CHUNK_SIZE = 32;
+
+        std::vector<std::unique_ptr<NodeStorage[]>> m_chunks;
+        FreeNode* m_free = nullptr;
+
+        void grow()
+        {
+            m_chunks.emplace_back(new NodeStorage[CHUNK_SIZE]);
+            NodeStorage* chunk = m_chunks.back().get();
+
+            for (size_t i = 0; i < CHUNK_SIZE; ++i)
+                release(&chunk[i]);
+        }
+
+        void* acquire()
+        {
+            if (!m_free)
+                grow();
+
+            FreeNode* node = m_free;
+            m_free = node->m_next;
+            return node;
+        }
+
+        void release(void* memory)
+        {
+            FreeNode* node = new (memory) FreeNode{ m_free };
+            m_free = node;
+        }
+    };
+
+    StepPool& pool()
+    {
+        static StepPool s_pool;
+        return s_pool;
+    }
+}
+
+void* StepList::allocateNode()
+{
+    return pool().acquire();
+}
+
+void StepList::releaseNode(GoalStep* step)
+{
+    step->~GoalStep();
+    pool().release(step);
+}
+
+void StepList::popFront()
+{
+    GoalStep* step = m_head;
+    m_head = step->m_next;
+    if (!m_head)
+        m_tail = nullptr;
+
+    --m_size;
+    releaseNode(step);
+}
+
+void StepList::clear()
+{
+    while (!empty())
+        popFront();
+}
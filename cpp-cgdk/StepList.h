@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+
+#include "InplaceCallback.h"
+#include "WakeCondition.h"
+
+struct GoalStep
+{
+    const char*     m_debugName;
+
+    InplaceCallback m_shouldAbort;
+    InplaceCallback m_shouldProceed;
+    InplaceCallback m_proceed;
+    bool            m_isMultitaskPoint;
+    WakeCondition   m_wake;             // until it fires, m_shouldProceed is known to be false
+
+    GoalStep*       m_next = nullptr;   // intrusive link of StepList
+
+    GoalStep(InplaceCallback&& shouldAbort, InplaceCallback&& shouldProceed, InplaceCallback&& proceed, const char* debugName, bool isMultitaskPoint,
+             const WakeCondition& wake)
+        : m_debugName(debugName), m_shouldAbort(std::move(shouldAbort)), m_shouldProceed(std::move(shouldProceed)), m_proceed(std::move(proceed))
+        , m_isMultitaskPoint(isMultitaskPoint), m_wake(wake)
+    {}
+};
+
+// Singly linked queue of goal steps. Nodes come from a free list shared by all goals and go back there,
+// so once the pool has grown to the peak number of live steps, pushing a step doesn't allocate
+class StepList
+{
+public:
+    StepList() {}
+    ~StepList()                                 { clear(); }
+
+    StepList(const StepList&) = delete;
+    StepList& operator=(const StepList&) = delete;
+
+    bool            empty() const               { return m_head == nullptr; }
+    size_t          size() const                { return m_size; }
+    GoalStep&       front()                     { return *m_head; }
+    const GoalStep& front() const               { return *m_head; }
+
+    template <typename... Args>
+    void emplaceBack(Args&&... args)
+    {
+        GoalStep* step = create(std::forward<Args>(args)...);
+        if (m_tail)
+            m_tail->m_next = step;
+        else
+            m_head = step;
+
+        m_tail = step;
+    }
+
+    template <typename... Args>
+    void emplaceFront(Args&&... args)
+    {
+        GoalStep* step = create(std::forward<Args>(args)...);
+        step->m_next = m_head;
+        m_head = step;
+
+        if (!m_tail)
+            m_tail = step;
+    }
+
+    // right after the front step, which is usually the one being performed
+    template <typename... Args>
+    void emplaceSecond(Args&&... args)
+    {
+        if (empty())
+            return emplaceBack(std::forward<Args>(args)...);
+
+        GoalStep* step = create(std::forward<Args>(args)...);
+        step->m_next = m_head->m_next;
+        m_head->m_next = step;
+
+        if (m_tail == m_head)
+            m_tail = step;
+    }
+
+    void popFront();
+    void clear();
+
+    template <typename Predicate>
+    bool any(Predicate predicate) const
+    {
+        for (const GoalStep* step = m_head; step; step = step->m_next)
+            if (predicate(*step))
+                return true;
+
+        return false;
+    }
+
+private:
+    static void* allocateNode();
+    static void  releaseNode(GoalStep* step);
+
+    template <typename... Args>
+    GoalStep* create(Args&&... args)
+    {
+        GoalStep* step = new (allocateNode()) GoalStep(std::forward<Args>(args)...);
+        ++m_size;
+        return step;
+    }
+
+    GoalStep* m_head = nullptr;
+    GoalStep* m_tail = nullptr;
+    size_t    m_size = 0;
+};
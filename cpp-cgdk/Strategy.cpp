@@ -1,3 +1,7 @@
 #include "Strategy.h"
 
+VehicleUpdateSink* Strategy::getVehicleUpdateSink() {
+    return nullptr;
+}
+
 Strategy::~Strategy() { }
@@ -6,11 +6,15 @@
 #include "model/Game.h"
 #include "model/Move.h"
 #include "model/World.h"
+#include "VehicleUpdateSink.h"
 
 class Strategy {
 public:
     virtual void move(const model::Player& me, const model::World& world, const model::Game& game, model::Move& move) = 0;
 
+    // when not null, vehicle updates are streamed into the sink and World::getVehicleUpdates() stays empty
+    virtual VehicleUpdateSink* getVehicleUpdateSink();
+
     virtual ~Strategy();
 };
 
@@ -0,0 +1,129 @@
+#include "VehicleGrid.h"
+#include <algorithm>
+#include <utility>
+
+const int VehicleGrid::INVALID_CELL;
+
+VehicleGrid::VehicleGrid(const VehicleStore& store)
+    : m_store(store)
+    , m_cells(CELLS * CELLS)
+{
+}
+
+void VehicleGrid::add(Slot slot)
+{
+    if (slot >= m_cellBySlot.size())
+    {
+        m_cellBySlot.resize(slot + 1, INVALID_CELL);
+        m_indexInCell.resize(slot + 1, 0);
+    }
+
+    insert(slot, cellIndex(m_store.point(slot)));
+}
+
+void VehicleGrid::move(Slot slot)
+{
+    int cell = cellIndex(m_store.point(slot));
+    if (cell == m_cellBySlot[slot])
+        return;
+
+    erase(slot);
+    insert(slot, cell);
+}
+
+void VehicleGrid::remove(Slot slot)
+{
+    if (m_cellBySlot[slot] != INVALID_CELL)
+        erase(slot);
+}
+
+void VehicleGrid::insert(Slot slot, int cell)
+{
+    std::vector<Slot>& units = m_cells[cell];
+
+    m_cellBySlot[slot]  = cell;
+    m_indexInCell[slot] = static_cast<uint32_t>(units.size());
+    units.push_back(slot);
+}
+
+void VehicleGrid::erase(Slot slot)
+{
+    std::vector<Slot>& units = m_cells[m_cellBySlot[slot]];
+    uint32_t index = m_indexInCell[slot];
+
+    // swap with last and pop
+    units[index] = units.back();
+    m_indexInCell[units[index]] = index;
+    units.pop_back();
+
+    m_cellBySlot[slot] = INVALID_CELL;
+}
+
+void VehicleGrid::nearest(const Point& center, size_t k, const Filter& filter, std::vector<Slot>& result) const
+{
+    result.clear();
+    if (k == 0)
+        return;
+
+    typedef std::pair<double, Slot> Candidate;
+    std::vector<Candidate> candidates;
+
+    const int centerX = clampCell(center.m_x);
+    const int centerY = clampCell(center.m_y);
+
+    auto visitCell = [this, &center, &filter, &candidates](int x, int y)
+    {
+        if (x < 0 || y < 0 || x >= CELLS || y >= CELLS)
+            return;
+
+        for (Slot slot : m_cells[x * CELLS + y])
+            if (filter.matches(m_store, slot))
+                candidates.emplace_back(center.getSquareDistance(m_store.point(slot)), slot);
+    };
+
+    // visit cells ring by ring. Everything outside of ring R is at least R * CELL_SIZE away from the center
+    for (int ring = 0; ring < CELLS; ++ring)
+    {
+        if (ring == 0)
+        {
+            visitCell(centerX, centerY);
+        }
+        else
+        {
+            for (int i = -ring; i <= ring; ++i)
+            {
+                visitCell(centerX + i, centerY - ring);
+                visitCell(centerX + i, centerY + ring);
+            }
+
+            for (int i = -ring + 1; i <= ring - 1; ++i)
+            {
+                visitCell(centerX - ring, centerY + i);
+                visitCell(centerX + ring, centerY + i);
+            }
+        }
+
+        if (candidates.size() >= k)
+        {
+            std::nth_element(candidates.begin(), candidates.begin() + (k - 1), candidates.end());
+            candidates.resize(k);
+
+            const double minOutsideDistance = static_cast<double>(ring * CELL_SIZE);
+            if (candidates.back().first <= minOutsideDistance * minOutsideDistance)
+                break;
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    result.reserve(candidates.size());
+    for (const Candidate& candidate : candidates)
+        result.push_back(candidate.second);
+}
+
+VehicleGrid::Slot VehicleGrid::nearest(const Point& center, const Filter& filter) const
+{
+    std::vector<Slot> result;
+    nearest(center, 1, filter, result);
+    return result.empty() ? VehicleStore::INVALID_SLOT : result.front();
+}
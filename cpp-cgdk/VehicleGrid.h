@@ -0,0 +1,120 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+#include "VehicleStore.h"
+
+// Uniform grid over the world, keeps alive vehicles of VehicleStore bucketed by cell.
+// Updated incrementally when vehicle moves to another cell, so range queries cost O(units nearby).
+class VehicleGrid
+{
+public:
+    typedef VehicleStore::Slot Slot;
+
+    static const int    WORLD_SIZE = 1024;
+    static const int    CELL_SIZE  = 32;
+    static const int    CELLS      = WORLD_SIZE / CELL_SIZE;
+
+    struct Filter
+    {
+        enum class Owner { eANY, eMINE, eENEMY };
+
+        Owner    m_owner    = Owner::eANY;
+        uint32_t m_typeMask = 0;       // bit per VehicleType, 0 means any type
+        const VehicleGroup* m_group = nullptr;   // State group owning the unit, null means any
+
+        static Filter any()                                       { return Filter(); }
+        static Filter mine(model::VehicleType type = model::VehicleType::_UNKNOWN_)  { return Filter(Owner::eMINE, type); }
+        static Filter enemy(model::VehicleType type = model::VehicleType::_UNKNOWN_) { return Filter(Owner::eENEMY, type); }
+
+        static Filter memberOf(const VehicleGroup& group)         { Filter filter; filter.m_group = &group; return filter; }
+
+        static uint32_t typeBit(model::VehicleType type)          { return 1u << static_cast<int>(type); }
+
+        Filter& add(model::VehicleType type)                      { m_typeMask |= typeBit(type); return *this; }
+
+        bool matches(const VehicleStore& store, Slot slot) const
+        {
+            if (m_owner != Owner::eANY && store.isMine(slot) != (m_owner == Owner::eMINE))
+                return false;
+
+            if (m_group && store.owner(slot) != m_group)
+                return false;
+
+            return m_typeMask == 0 || (m_typeMask & typeBit(store.type(slot))) != 0;
+        }
+
+        Filter() = default;
+        Filter(Owner owner, model::VehicleType type) : m_owner(owner), m_typeMask(type != model::VehicleType::_UNKNOWN_ ? typeBit(type) : 0) {}
+    };
+
+    explicit VehicleGrid(const VehicleStore& store);
+
+    void add(Slot slot);
+    void move(Slot slot);       // call after store position update
+    void remove(Slot slot);
+
+    template <typename Func> void forEachInRect(const Rect& rect, const Filter& filter, Func&& func) const;
+    template <typename Func> void forEachInRadius(const Point& center, double radius, const Filter& filter, Func&& func) const;
+
+    // up to k nearest vehicles sorted by distance ascending
+    void nearest(const Point& center, size_t k, const Filter& filter, std::vector<Slot>& result) const;
+    Slot nearest(const Point& center, const Filter& filter) const;
+
+private:
+    static const int INVALID_CELL = -1;
+
+    struct CellRange
+    {
+        int m_minX, m_minY, m_maxX, m_maxY;
+    };
+
+    static int clampCell(double coordinate)
+    {
+        int cell = static_cast<int>(coordinate) / CELL_SIZE;
+        return cell < 0 ? 0 : (cell >= CELLS ? CELLS - 1 : cell);
+    }
+
+    int       cellIndex(const Point& p) const      { return clampCell(p.m_x) * CELLS + clampCell(p.m_y); }
+    CellRange cellRange(const Rect& rect) const    { return CellRange{ clampCell(rect.m_topLeft.m_x), clampCell(rect.m_topLeft.m_y), clampCell(rect.m_bottomRight.m_x), clampCell(rect.m_bottomRight.m_y) }; }
+
+    void insert(Slot slot, int cell);
+    void erase(Slot slot);
+
+    const VehicleStore&             m_store;
+    std::vector<std::vector<Slot>>  m_cells;        // x-major, cell index is x * CELLS + y
+    std::vector<int>                m_cellBySlot;
+    std::vector<uint32_t>           m_indexInCell;  // position of slot inside its cell, for O(1) removal
+};
+
+template <typename Func>
+void VehicleGrid::forEachInRect(const Rect& rect, const Filter& filter, Func&& func) const
+{
+    const CellRange range = cellRange(rect);
+
+    for (int x = range.m_minX; x <= range.m_maxX; ++x)
+    {
+        for (int y = range.m_minY; y <= range.m_maxY; ++y)
+        {
+            for (Slot slot : m_cells[x * CELLS + y])
+            {
+                if (filter.matches(m_store, slot) && rect.contains(m_store.point(slot)))
+                    func(slot);
+            }
+        }
+    }
+}
+
+template <typename Func>
+void VehicleGrid::forEachInRadius(const Point& center, double radius, const Filter& filter, Func&& func) const
+{
+    const double squaredRadius = radius * radius;
+    const Rect   bounds = Rect(center, center).inflate(radius);
+
+    forEachInRect(bounds, filter, [this, &center, squaredRadius, &func](Slot slot)
+    {
+        if (center.getSquareDistance(m_store.point(slot)) <= squaredRadius)
+            func(slot);
+    });
+}
@@ -1,9 +1,99 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "VehicleGroup.h"
+#include "ContactKernel.h"
 #include "noReleaseAssert.h"
 
+void VehicleGroup::add(const VehicleStore& store, VehicleStore::Slot slot)
+{
+    Point unitPoint = store.point(slot);
+
+    m_unitsRect = m_units.empty() ? Rect(unitPoint, unitPoint) : m_unitsRect;
+    m_unitsRect.ensureContains(unitPoint);
+
+    m_store = &store;
+    m_units.push_back(slot);
+
+    m_positionSum   += unitPoint;
+    m_healthSum     += store.durability(slot);
+    m_maxUnitRadius  = std::max(m_maxUnitRadius, store.radius(slot));
+    m_isDirty        = true;
+}
+
+void VehicleGroup::onUnitChanged(VehicleStore::Slot slot, const Point& oldPosition, int oldDurability)
+{
+    Point newPosition = m_store->point(slot);
+
+    m_positionSum += newPosition - oldPosition;
+    m_healthSum   += m_store->durability(slot) - oldDurability;
+    m_isDirty      = true;
+
+    if (m_isRectDirty || (newPosition.m_x == oldPosition.m_x && newPosition.m_y == oldPosition.m_y))
+        return;
+
+    bool isOnBoundary = oldPosition.m_x == m_unitsRect.m_topLeft.m_x     || oldPosition.m_y == m_unitsRect.m_topLeft.m_y
+                     || oldPosition.m_x == m_unitsRect.m_bottomRight.m_x || oldPosition.m_y == m_unitsRect.m_bottomRight.m_y;
+
+    if (isOnBoundary)
+        m_isRectDirty = true;   // rect may shrink, recalculate it later
+    else
+        m_unitsRect.ensureContains(newPosition);
+}
+
+void VehicleGroup::onUnitDied(const Point& oldPosition, int oldDurability)
+{
+    m_positionSum -= oldPosition;
+    m_healthSum   -= oldDurability;
+    m_isDirty      = true;
+    m_hasDead      = true;
+    m_isRectDirty  = true;
+}
+
+void VehicleGroup::applyDeltas()
+{
+    if (!m_isDirty || m_store == nullptr)
+        return;
+
+    if (m_hasDead)
+    {
+        // sums are recalculated as well to prevent floating point error accumulation
+        update();
+        return;
+    }
+
+    if (m_isRectDirty)
+    {
+        const VehicleStore& store = *m_store;
+
+        m_unitsRect = Rect(store.point(m_units.front()), store.point(m_units.front()));
+        for (VehicleStore::Slot slot : m_units)
+            m_unitsRect.ensureContains(store.point(slot));
+    }
+
+    m_center      = m_positionSum / static_cast<double>(m_units.size());
+    m_rect        = m_unitsRect.inflate(m_store->radius(m_units.front()));
+    m_isDirty     = false;
+    m_isRectDirty = false;
+}
+
 void VehicleGroup::update()
 {
-    auto eraseIt = std::remove_if(m_units.begin(), m_units.end(), [](const VehicleCache& unitCache) { return unitCache.expired(); });
+    m_isDirty = m_isRectDirty = m_hasDead = false;
+
+    if (m_store == nullptr)
+    {
+        m_center      = Point();
+        m_rect        = m_unitsRect = Rect();
+        m_positionSum = Point();
+        m_healthSum   = m_maxUnitRadius = 0;
+        return;
+    }
+
+    const VehicleStore& store = *m_store;
+
+    auto eraseIt = std::remove_if(m_units.begin(), m_units.end(), [&store](VehicleStore::Slot slot) { return !store.isAlive(slot); });
     if (eraseIt != m_units.end())
         m_units.erase(eraseIt, m_units.end());
 
@@ -11,143 +101,164 @@ void VehicleGroup::update()
     double healthSum = 0;
     double maxRadius = 0;
 
-    Rect   rect = m_units.empty() ? Rect() : Rect(*m_units.front().lock(), *m_units.front().lock());
+    Rect   rect = m_units.empty() ? Rect() : Rect(store.point(m_units.front()), store.point(m_units.front()));
     
-    for (const VehicleCache& unitCache : m_units)
+    for (VehicleStore::Slot slot : m_units)
     {
-        assert(!unitCache.expired());
-        const VehiclePtr unit = unitCache.lock();
-
-        Point unitPoint = *unit;
+        Point unitPoint = store.point(slot);
         rect.ensureContains(unitPoint);
         center += unitPoint;
 
-        healthSum += unit->getDurability();
+        healthSum += store.durability(slot);
 
-        maxRadius = std::max(maxRadius, unit->getRadius());
+        maxRadius = std::max(maxRadius, store.radius(slot));
     }
 
+    m_positionSum   = center;
+    m_unitsRect     = rect;
+
     center /= static_cast<double>(m_units.size());
 
     m_center        = center;
-    m_rect          = rect.inflate(m_units.empty() ? 0.0 : m_units.front().lock()->getRadius());
+    m_rect          = rect.inflate(m_units.empty() ? 0.0 : store.radius(m_units.front()));
     m_healthSum     = healthSum;
     m_maxUnitRadius = maxRadius;
 }
 
-bool VehicleGroup::isPathFree(const Point& toCenter, const Obstacle& obstacle, double iterationSize, bool isRoughCalculation /*= false*/) const
+// time interval when segment [min, max] moving by velocity overlaps with static [otherMin, otherMax]
+static bool getOverlapInterval(double min, double max, double velocity, double otherMin, double otherMax, double& enter, double& exit)
 {
-    Vec2d  direction = Vec2d::fromPoint(toCenter - m_center).truncate(iterationSize);
-    double distance = m_center.getDistanceTo(toCenter);
-
-    bool  isPathFree = true;
-    Vec2d move = direction;
-    do
+    if (velocity == 0)
     {
-        isPathFree = !willCollide(move, obstacle, isRoughCalculation);
-        move += direction;
-    } while (move.length() < distance && isPathFree);
+        enter = -std::numeric_limits<double>::infinity();
+        exit  =  std::numeric_limits<double>::infinity();
+        return min <= otherMax && max >= otherMin;
+    }
 
-    // also check final destination:
-    if (isPathFree)
-        isPathFree = !willCollide(move.truncate(distance), obstacle, isRoughCalculation);
+    double t1 = (otherMin - max) / velocity;
+    double t2 = (otherMax - min) / velocity;
 
-    return isPathFree;
+    enter = std::min(t1, t2);
+    exit  = std::max(t1, t2);
+    return true;
 }
 
-bool VehicleGroup::willCollide(const Vec2d& thisDisplacement, const Obstacle& other, bool isRoughCalculation) const
+template <typename Moving, typename Other>
+bool findFirstContact(const Moving& moving, const Vec2d& displacement, const Other& other, const Vec2d& otherDisplacement, double& contactTime)
 {
-    Rect intersection;
-    Rect actualRect = m_rect + thisDisplacement;
-    if (!actualRect.overlaps(other.rect(), intersection))
-        return false;
+    // everything below is relative to the other set, so it stays in place
+    const Vec2d  velocity  = displacement - otherDisplacement;
+    const Rect&  rect      = moving.m_rect;
+    const Rect&  otherRect = other.m_rect;
 
-    intersection = intersection.inflate(m_maxUnitRadius + other.maxUnitRadius());
+    // broad phase: moving rect vs other one, i.e. the point vs their Minkowski sum
 
-    for (const VehicleCache& vehicleCache : m_units)
+    double enterX, exitX, enterY, exitY;
+    if (!getOverlapInterval(rect.m_topLeft.m_x, rect.m_bottomRight.m_x, velocity.m_x, otherRect.m_topLeft.m_x, otherRect.m_bottomRight.m_x, enterX, exitX)
+        || !getOverlapInterval(rect.m_topLeft.m_y, rect.m_bottomRight.m_y, velocity.m_y, otherRect.m_topLeft.m_y, otherRect.m_bottomRight.m_y, enterY, exitY))
     {
-        VehiclePtr vehicle = vehicleCache.lock();
-        Point actualCenter = Point(*vehicle) + thisDisplacement;
-
-        if (!intersection.contains(actualCenter))
-            continue;
-
-        for(size_t i = 0; i < other.getUnitsCount(); ++i)
-        {
-            Point otherPoint = other.getUnitPoint(i);
-            if (!intersection.contains(otherPoint))
-                continue;
+        return false;
+    }
 
-            if (isRoughCalculation)
-                return true;
+    const double enter = std::max({ enterX, enterY, 0.0 });
+    const double exit  = std::min({ exitX,  exitY,  1.0 });
+    if (enter > exit)
+        return false;
 
-            double squaredDistance = actualCenter.getSquareDistance(otherPoint);
-            double sqaredRadius    = Point::pow2(vehicle->getRadius() + other.getUnitRadius(i));
+    // units which may take part in contact: those swept through other rect, and those inside of the swept rect.
+    // Positions and radii are gathered once into flat arrays
 
-            if (squaredDistance < sqaredRadius)
-                return true; 
-        }
-    }
+    Rect sweptRect = rect;
+    sweptRect.ensureContains(rect + velocity);
 
-    return false;
-}
+    const Rect otherArea  = otherRect.inflate(moving.maxUnitRadius());
+    const Rect movingArea = sweptRect.inflate(other.maxUnitRadius());
 
+    // sweep goes along the axis where units move less, so swept intervals stay short
+    const bool isSweepByX = std::abs(velocity.m_x) <= std::abs(velocity.m_y);
 
-bool VehicleGroupGhost::isPathFree(const Point& toCenter, const Obstacle& obstacle, double iterationSize, bool isRoughCalculation /*= false*/) const
-{
-    Vec2d  direction = Vec2d::fromPoint(toCenter - m_center).truncate(iterationSize);
-    double distance = m_center.getDistanceTo(toCenter);
+    struct Circle
+    {
+        double m_sweep;     // coordinate along the sweep axis
+        double m_cross;     // coordinate along the other axis
+        double m_radius;
+    };
 
-    bool  isPathFree = true;
-    Vec2d move = direction;
-    do
+    auto toCircle = [isSweepByX](const Point& p, double radius)
     {
-        isPathFree = !willCollide(move, obstacle, isRoughCalculation);
-        move += direction;
-    } while (move.length() < distance && isPathFree);
+        return isSweepByX ? Circle{ p.m_x, p.m_y, radius } : Circle{ p.m_y, p.m_x, radius };
+    };
 
-    // also check final destination:
-    if (isPathFree)
-        isPathFree = !willCollide(move.truncate(distance), obstacle, isRoughCalculation);
+    std::vector<Circle> movingUnits;
+    for (size_t i = 0; i < moving.unitsCount(); ++i)
+    {
+        const Point from = moving.unitPoint(i);
+        Rect unitSwept(from, from);
+        unitSwept.ensureContains(from + velocity);
 
-    return isPathFree;
-}
+        if (unitSwept.overlaps(otherArea))
+            movingUnits.push_back(toCircle(from, moving.unitRadius(i)));
+    }
 
-bool VehicleGroupGhost::willCollide(const Vec2d& thisDisplacement, const Obstacle& other, bool isRoughCalculation /*= false*/) const
-{
-    Rect intersection;
-    Rect actualRect = m_rect + thisDisplacement;
-    if (!actualRect.overlaps(other.rect(), intersection))
+    if (movingUnits.empty())
         return false;
 
-    intersection = intersection.inflate(m_original.m_maxUnitRadius + other.maxUnitRadius());
+    std::vector<Circle> otherUnits;
+    for (size_t i = 0; i < other.unitsCount(); ++i)
+    {
+        const Point otherPoint = other.unitPoint(i);
+        if (movingArea.contains(otherPoint))
+            otherUnits.push_back(toCircle(otherPoint, other.unitRadius(i)));
+    }
+
+    std::sort(otherUnits.begin(), otherUnits.end(), [](const Circle& a, const Circle& b) { return a.m_sweep < b.m_sweep; });
 
-    for (size_t groupIndex = 0; groupIndex < m_unitPlaces.size(); ++groupIndex)
+    // flat arrays for the vectorized kernel
+    std::vector<double> otherSweep(otherUnits.size()), otherCross(otherUnits.size()), otherRadius(otherUnits.size());
+    for (size_t i = 0; i < otherUnits.size(); ++i)
     {
-        VehiclePtr vehicle = m_original.m_units[groupIndex].lock();
-        Point actualCenter = m_unitPlaces[groupIndex] + thisDisplacement;
+        otherSweep[i]  = otherUnits[i].m_sweep;
+        otherCross[i]  = otherUnits[i].m_cross;
+        otherRadius[i] = otherUnits[i].m_radius;
+    }
 
-        if (!intersection.contains(actualCenter))
-            continue;
+    // narrow phase: obstacle units within the swept interval along the sweep axis, see findEarliestContact()
 
-        for (size_t otherIndex = 0; otherIndex < other.getUnitsCount(); ++otherIndex)
-        {
-            Point otherPoint = other.getUnitPoint(otherIndex);
-            if (!intersection.contains(otherPoint))
-                continue;
+    const double vSweep = isSweepByX ? velocity.m_x : velocity.m_y;
+    const double vCross = isSweepByX ? velocity.m_y : velocity.m_x;
+    const double reach  = moving.maxUnitRadius() + other.maxUnitRadius();
 
-            if (isRoughCalculation)
-                return true;
+    bool   hasContact = false;
+    double earliest   = 1;
+
+    for (const Circle& unit : movingUnits)
+    {
+        const double sweepMin = std::min(unit.m_sweep, unit.m_sweep + vSweep) - reach;
+        const double sweepMax = std::max(unit.m_sweep, unit.m_sweep + vSweep) + reach;
 
-            double squaredDistance = actualCenter.getSquareDistance(otherPoint);
-            double sqaredRadius = Point::pow2(vehicle->getRadius() + other.getUnitRadius(otherIndex));
+        const size_t begin = std::lower_bound(otherSweep.begin(), otherSweep.end(), sweepMin) - otherSweep.begin();
+        const size_t end   = std::upper_bound(otherSweep.begin() + begin, otherSweep.end(), sweepMax) - otherSweep.begin();
 
-            if (squaredDistance < sqaredRadius)
-                return true;
+        const MovingCircle circle{ unit.m_sweep, unit.m_cross, unit.m_radius, vSweep, vCross };
+
+        double t = 0;
+        if (findEarliestContact(circle, otherSweep.data() + begin, otherCross.data() + begin, otherRadius.data() + begin, end - begin, t))
+        {
+            if (!hasContact || t < earliest)
+            {
+                earliest   = t;
+                hasContact = true;
+            }
         }
     }
 
-    return false;
+    if (hasContact)
+        contactTime = earliest;
+
+    return hasContact;
 }
 
-const VehicleGroupGhost Obstacle::s_nullGhost = VehicleGroupGhost(VehicleGroup(), Vec2d());
+template bool findFirstContact(const VehicleGroup&,      const Vec2d&, const VehicleGroup&,      const Vec2d&, double&);
+template bool findFirstContact(const VehicleGroup&,      const Vec2d&, const VehicleGroupGhost&, const Vec2d&, double&);
+template bool findFirstContact(const VehicleGroupGhost&, const Vec2d&, const VehicleGroup&,      const Vec2d&, double&);
+template bool findFirstContact(const VehicleGroupGhost&, const Vec2d&, const VehicleGroupGhost&, const Vec2d&, double&);
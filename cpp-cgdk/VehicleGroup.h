@@ -5,11 +5,9 @@
 #include "geometry.h"
 
 #include "model/Vehicle.h"
+#include "VehicleStore.h"
 
-typedef std::shared_ptr<model::Vehicle> VehiclePtr;
-typedef std::weak_ptr<model::Vehicle>   VehicleCache;
-
-class Obstacle;
+typedef const model::Vehicle* VehiclePtr;
 
 class GroupHandle
 {
@@ -73,78 +71,94 @@ namespace std
 
 struct VehicleGroup
 {
-    std::vector<VehicleCache> m_units;
+    typedef std::vector<VehicleStore::Slot> Units;
+
+    const VehicleStore* m_store = nullptr;
+    Units  m_units;
     Point  m_center;
     Rect   m_rect;
-    double m_healthSum;
-    double m_maxUnitRadius;
+    double m_healthSum     = 0;
+    double m_maxUnitRadius = 0;
     Point  m_plannedDestination;
 
+    // incrementally maintained aggregates, see applyDeltas()
+    Point  m_positionSum;
+    Rect   m_unitsRect;               // rect of unit centers, not inflated
+    bool   m_isDirty     = false;
+    bool   m_isRectDirty = false;     // unit from the boundary of m_unitsRect has moved or died
+    bool   m_hasDead     = false;
+
     // TODO refactor: add getters/setters
     void  setPlannedDestination(const Point& dest = Point()) { m_plannedDestination = dest; }
     bool  hasPlannedDestination() const                      { return m_plannedDestination != Point(0,0); }
     Point getPredictedCenter() const                         { return hasPlannedDestination() ? m_plannedDestination : m_center; }
 
-    void add(const VehiclePtr& vehicle)     { m_units.emplace_back(vehicle); }
+    void add(const VehicleStore& store, VehicleStore::Slot slot);
 
+    const model::Vehicle& unit(size_t i) const               { return m_store->vehicle(m_units[i]); }
+    const model::Vehicle& front() const                      { return unit(0); }
+    Point                 unitPoint(size_t i) const          { return m_store->point(m_units[i]); }
+    double                unitRadius(size_t i) const         { return m_store->radius(m_units[i]); }
+    size_t                unitsCount() const                 { return m_units.size(); }
+    double                maxUnitRadius() const              { return m_maxUnitRadius; }
+
+    // full recalculation, needed when m_units is modified directly
     void update();
+
+    // unit deltas, store is already updated. Aggregates are finalized by applyDeltas()
+    void onUnitChanged(VehicleStore::Slot slot, const Point& oldPosition, int oldDurability);
+    void onUnitDied(const Point& oldPosition, int oldDurability);
+    void applyDeltas();
     
-    bool isPathFree(const Point& to, const Obstacle& obstacle, double iterationSize, bool isRoughCalculation = false) const;
-    bool willCollide(const Vec2d& thisDisplacement, const Obstacle& other, bool isRoughCalculation) const;
+    // moving to destination (obstacle stays) doesn't make any unit overlap with the obstacle.
+    // Obstacle is either VehicleGroup or VehicleGroupGhost
+    template <typename Obstacle>
+    bool isPathFree(const Point& to, const Obstacle& obstacle) const;
 };
 
+// The group shifted by displacement. A view over the original group, unit positions are computed on access
 struct VehicleGroupGhost
 {
     const VehicleGroup& m_original;
-    std::vector<Point>  m_unitPlaces;
+    Vec2d m_displacement;
     Point m_center;
     Rect  m_rect;
 
     VehicleGroupGhost(const VehicleGroup& group, const Vec2d& displacement)
         : m_original(group)
-        , m_unitPlaces()
+        , m_displacement(displacement)
         , m_center(group.m_center + displacement)
         , m_rect(group.m_rect + displacement)
     {
-        const std::vector<VehicleCache>& units = m_original.m_units;
-        m_unitPlaces.reserve(units.size());
-
-        for (const VehicleCache& unitCache : units)
-            m_unitPlaces.emplace_back(Point(*unitCache.lock()) + displacement);
     }
 
-    // TODO- remove duplication with VehicleGroup
-    bool isPathFree(const Point& to, const Obstacle& obstacle, double iterationSize, bool isRoughCalculation = false) const;
-    bool willCollide(const Vec2d& thisDisplacement, const Obstacle& other, bool isRoughCalculation) const;
-
-
-    VehicleGroupGhost(VehicleGroupGhost&&) = default;
-    VehicleGroupGhost& operator=(VehicleGroupGhost&&) = default;
+    Point  unitPoint(size_t i) const    { return m_original.unitPoint(i) + m_displacement; }
+    double unitRadius(size_t i) const   { return m_original.unitRadius(i); }
+    size_t unitsCount() const           { return m_original.unitsCount(); }
+    double maxUnitRadius() const        { return m_original.maxUnitRadius(); }
 
-    VehicleGroupGhost(const VehicleGroupGhost&) = delete;
-    VehicleGroupGhost& operator=(const VehicleGroupGhost&) = delete;
+    template <typename Obstacle>
+    bool isPathFree(const Point& to, const Obstacle& obstacle) const;
 };
 
-class Obstacle
-{
-    static const VehicleGroupGhost s_nullGhost;
-
-    const bool               m_isReal;
-    const VehicleGroup&      m_real;
-    const VehicleGroupGhost& m_ghost;
+// Continuous collision of two unit sets moving linearly and simultaneously by their displacements, time goes from 0 to 1.
+// Returns true and the earliest time when some pair of units comes into contact. A pair already overlapping
+// at the start is a contact at 0 if it closes in and is ignored otherwise, so touching groups can still move apart.
+// Both sets are VehicleGroup or VehicleGroupGhost, all four combinations are instantiated in VehicleGroup.cpp
+template <typename Moving, typename Other>
+bool findFirstContact(const Moving& moving, const Vec2d& displacement, const Other& other, const Vec2d& otherDisplacement, double& contactTime);
 
-public:
-
-    explicit Obstacle(const VehicleGroup&      real)  : m_isReal(true),  m_real(real),             m_ghost(s_nullGhost) {}
-    explicit Obstacle(const VehicleGroupGhost& ghost) : m_isReal(false), m_real(ghost.m_original), m_ghost(ghost)       {}
-
-    const Point& center() const { return m_isReal ? m_real.m_center : m_ghost.m_center; }
-    const Rect&  rect() const   { return m_isReal ? m_real.m_rect   : m_ghost.m_rect; }
-
-    double maxUnitRadius() const { return m_real.m_maxUnitRadius; }
+template <typename Obstacle>
+bool VehicleGroup::isPathFree(const Point& toCenter, const Obstacle& obstacle) const
+{
+    double contactTime = 0;
+    return !findFirstContact(*this, toCenter - m_center, obstacle, Vec2d(), contactTime);
+}
 
-    size_t getUnitsCount() const         { return m_real.m_units.size(); }
-    Point  getUnitPoint(size_t i) const  { return m_isReal ? Point(*m_real.m_units[i].lock()) : m_ghost.m_unitPlaces[i]; }
-    double getUnitRadius(size_t i) const { return m_real.m_units[i].lock()->getRadius(); }
-};
+template <typename Obstacle>
+bool VehicleGroupGhost::isPathFree(const Point& toCenter, const Obstacle& obstacle) const
+{
+    double contactTime = 0;
+    return !findFirstContact(*this, toCenter - m_center, obstacle, Vec2d(), contactTime);
+}
 
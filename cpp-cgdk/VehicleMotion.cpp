@@ -0,0 +1,71 @@
+#include "VehicleMotion.h"
+
+void VehicleMotion::reset(Slot slot)
+{
+    if (slot < m_history.size())
+        m_history[slot] = History();
+}
+
+void VehicleMotion::record(Slot slot, int tick, const Point& position)
+{
+    if (slot >= m_history.size())
+        m_history.resize(slot + 1);
+
+    History& history = m_history[slot];
+
+    if (history.m_count > 0)
+    {
+        // unit stood still since its last sample, so it was there at the previous tick too. One sample is enough:
+        // velocity() stops at the first gap, so the move is measured from where the unit started it
+        const Sample previous = history.m_samples[history.m_head];
+        if (previous.m_tick < tick - 1)
+            push(history, Sample{ tick - 1, previous.m_x, previous.m_y });
+    }
+
+    push(history, Sample{ tick, static_cast<float>(position.m_x), static_cast<float>(position.m_y) });
+}
+
+void VehicleMotion::push(History& history, const Sample& sample)
+{
+    history.m_head = static_cast<uint8_t>((history.m_head + 1) % HISTORY_SIZE);
+    history.m_samples[history.m_head] = sample;
+
+    if (history.m_count < HISTORY_SIZE)
+        ++history.m_count;
+}
+
+Vec2d VehicleMotion::velocity(Slot slot, int currentTick) const
+{
+    if (slot >= m_history.size())
+        return Vec2d();
+
+    const History& history = m_history[slot];
+    if (history.m_count < 2)
+        return Vec2d();
+
+    const Sample& newest = history.m_samples[history.m_head];
+    if (newest.m_tick != currentTick)
+        return Vec2d();     // no update this tick, i.e. unit stands still
+
+    // walk back while samples are from consecutive ticks, older moves may be unrelated to the current one
+    int oldestIndex = history.m_head;
+    for (int i = 1; i < history.m_count; ++i)
+    {
+        int index = (history.m_head - i + HISTORY_SIZE) % HISTORY_SIZE;
+        if (history.m_samples[index].m_tick != newest.m_tick - i)
+            break;
+
+        oldestIndex = index;
+    }
+
+    const Sample& oldest = history.m_samples[oldestIndex];
+    if (oldest.m_tick == newest.m_tick)
+        return Vec2d();
+
+    return Vec2d(newest.m_x - oldest.m_x, newest.m_y - oldest.m_y) / (newest.m_tick - oldest.m_tick);
+}
+
+Point VehicleMotion::predict(Slot slot, const Point& position, int currentTick, int ticksAhead) const
+{
+    return position + velocity(slot, currentTick) * ticksAhead;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+#include "VehicleStore.h"
+
+// Short position history per vehicle slot, used to extrapolate where units will be in a few ticks.
+// Server reports only changed vehicles, so a unit without a sample at the current tick is standing still.
+class VehicleMotion
+{
+public:
+    typedef VehicleStore::Slot Slot;
+
+    static const int HISTORY_SIZE = 4;
+
+    // position of the slot at tick, ticks of one slot must be increasing
+    void record(Slot slot, int tick, const Point& position);
+
+    // forgets the history of a recycled slot
+    void reset(Slot slot);
+
+    // average velocity over the last consecutive ticks, zero for a unit which didn't move at currentTick
+    Vec2d velocity(Slot slot, int currentTick) const;
+
+    Point predict(Slot slot, const Point& position, int currentTick, int ticksAhead) const;
+
+private:
+    struct Sample
+    {
+        int   m_tick;
+        float m_x;
+        float m_y;
+    };
+
+    struct History
+    {
+        Sample  m_samples[HISTORY_SIZE];
+        uint8_t m_head  = 0;        // index of the newest sample
+        uint8_t m_count = 0;
+    };
+
+    static void push(History& history, const Sample& sample);
+
+    std::vector<History> m_history;   // by slot
+};
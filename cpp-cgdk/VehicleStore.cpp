@@ -0,0 +1,93 @@
+#include "VehicleStore.h"
+#include <algorithm>
+
+const VehicleStore::Slot VehicleStore::INVALID_SLOT;
+
+VehicleStore::Slot VehicleStore::add(const model::Vehicle& vehicle, bool isMine)
+{
+    size_t index = static_cast<size_t>(vehicle.getId());
+    if (index >= m_slotById.size())
+        m_slotById.resize(std::max(index + 1, 2 * m_slotById.size()), INVALID_SLOT);
+
+    uint8_t flags = eALIVE;
+    if (isMine)
+        flags |= eMINE;
+    if (vehicle.isAerial())
+        flags |= eAERIAL;
+    if (vehicle.isSelected())
+        flags |= eSELECTED;
+
+    // own previous slot if it's still free, any free one otherwise
+    Slot slot = m_slotById[index];
+    auto freeIt = m_free.end();
+    if (slot != INVALID_SLOT && (m_flags[slot] & eRELEASED) != 0 && m_id[slot] == vehicle.getId())
+        freeIt = std::find(m_free.begin(), m_free.end(), slot);
+    else if (!m_free.empty())
+        freeIt = m_free.end() - 1;
+
+    if (freeIt != m_free.end())
+    {
+        slot = *freeIt;
+        *freeIt = m_free.back();
+        m_free.pop_back();
+
+        m_x[slot]          = vehicle.getX();
+        m_y[slot]          = vehicle.getY();
+        m_radius[slot]     = vehicle.getRadius();
+        m_durability[slot] = vehicle.getDurability();
+        m_id[slot]         = vehicle.getId();
+        m_type[slot]       = vehicle.getType();
+        m_flags[slot]      = flags;
+        m_owner[slot]      = nullptr;
+        m_records[slot]    = vehicle;
+    }
+    else
+    {
+        slot = static_cast<Slot>(m_flags.size());
+
+        m_x.push_back(vehicle.getX());
+        m_y.push_back(vehicle.getY());
+        m_radius.push_back(vehicle.getRadius());
+        m_durability.push_back(vehicle.getDurability());
+        m_id.push_back(vehicle.getId());
+        m_type.push_back(vehicle.getType());
+        m_flags.push_back(flags);
+        m_owner.push_back(nullptr);
+        m_records.push_back(vehicle);
+    }
+
+    m_slotById[index] = slot;
+    return slot;
+}
+
+void VehicleStore::update(Slot slot, double x, double y, int durability, int remainingAttackCooldownTicks, bool selected, const std::vector<int>& groups)
+{
+    m_x[slot]          = x;
+    m_y[slot]          = y;
+    m_durability[slot] = durability;
+    m_flags[slot]      = selected ? (m_flags[slot] | eSELECTED) : (m_flags[slot] & ~eSELECTED);
+
+    m_records[slot].update(x, y, durability, remainingAttackCooldownTicks, selected, groups);
+}
+
+void VehicleStore::kill(Slot slot)
+{
+    m_flags[slot]      = 0;
+    m_durability[slot] = 0;
+    m_owner[slot]      = nullptr;
+    m_dead.push_back(slot);
+}
+
+void VehicleStore::releaseDead()
+{
+    for (Slot slot : m_dead)
+    {
+        if (m_flags[slot] != 0)
+            continue;   // defensive: already alive again
+
+        m_flags[slot] = eRELEASED;
+        m_free.push_back(slot);
+    }
+
+    m_dead.clear();
+}
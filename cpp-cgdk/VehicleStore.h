@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "model/Vehicle.h"
+#include "geometry.h"
+
+struct VehicleGroup;
+
+// Vehicle table with stable slot indices. Hot per-unit data is kept in parallel arrays, so loops over units
+// stream contiguous memory; full model::Vehicle records are cold and only needed for rarely used fields.
+// A dead unit leaves a tombstone until releaseDead(), after that its slot is recycled by add(). Under fog of war
+// enemies vanish and appear again all the time, so without recycling the table would grow for the whole game.
+// A unit that appears again takes its own previous slot back if nobody has taken it yet.
+class VehicleStore
+{
+public:
+    typedef long long Id;
+    typedef uint32_t  Slot;
+
+    static const Slot INVALID_SLOT = static_cast<Slot>(-1);
+
+    enum Flags : uint8_t
+    {
+        eALIVE    = 1 << 0,
+        eMINE     = 1 << 1,
+        eAERIAL   = 1 << 2,
+        eSELECTED = 1 << 3,
+        eRELEASED = 1 << 4,     // dead and in the free list
+    };
+
+    // per-slot tables of other classes must be reset for the returned slot, it may have belonged to another unit
+    Slot add(const model::Vehicle& vehicle, bool isMine);
+    void update(Slot slot, double x, double y, int durability, int remainingAttackCooldownTicks, bool selected, const std::vector<int>& groups);
+    void kill(Slot slot);
+
+    // slots killed so far become reusable. Called when everybody has seen the kills, i.e. once per tick
+    void releaseDead();
+
+    // server ids are small increasing integers, so slot index is a plain array indexed by id
+    Slot findSlot(Id id) const
+    {
+        size_t index = static_cast<size_t>(id);   // negative id wraps to huge value and fails the range check
+        if (index >= m_slotById.size())
+            return INVALID_SLOT;
+
+        Slot slot = m_slotById[index];
+        return slot != INVALID_SLOT && isAlive(slot) && m_id[slot] == id ? slot : INVALID_SLOT;
+    }
+
+    // number of slots including dead and free ones
+    size_t size() const                                   { return m_flags.size(); }
+
+    bool   isAlive(Slot slot) const                       { return (m_flags[slot] & eALIVE) != 0; }
+    bool   isMine(Slot slot) const                        { return (m_flags[slot] & eMINE) != 0; }
+    bool   isAerial(Slot slot) const                      { return (m_flags[slot] & eAERIAL) != 0; }
+    bool   isSelected(Slot slot) const                    { return (m_flags[slot] & eSELECTED) != 0; }
+
+    double x(Slot slot) const                             { return m_x[slot]; }
+    double y(Slot slot) const                             { return m_y[slot]; }
+    Point  point(Slot slot) const                         { return Point(m_x[slot], m_y[slot]); }
+    double radius(Slot slot) const                        { return m_radius[slot]; }
+    int    durability(Slot slot) const                    { return m_durability[slot]; }
+    Id     id(Slot slot) const                            { return m_id[slot]; }
+    model::VehicleType type(Slot slot) const              { return m_type[slot]; }
+
+    // State group which receives position and durability deltas of the unit, may be null
+    VehicleGroup* owner(Slot slot) const                  { return m_owner[slot]; }
+    void          setOwner(Slot slot, VehicleGroup* group) { m_owner[slot] = group; }
+
+    // cold record, address is stable for the whole game
+    const model::Vehicle& vehicle(Slot slot) const        { return m_records[slot]; }
+
+private:
+    std::vector<double>             m_x;
+    std::vector<double>             m_y;
+    std::vector<double>             m_radius;
+    std::vector<int>                m_durability;
+    std::vector<Id>                 m_id;
+    std::vector<model::VehicleType> m_type;
+    std::vector<uint8_t>            m_flags;
+    std::vector<VehicleGroup*>      m_owner;
+    std::deque<model::Vehicle>      m_records;     // deque keeps references valid on growth
+
+    std::vector<Slot>               m_slotById;    // last slot of the id, valid only while alive and still holding the id
+    std::vector<Slot>               m_dead;        // killed since last releaseDead()
+    std::vector<Slot>               m_free;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#ifndef _VEHICLE_UPDATE_SINK_H_
+#define _VEHICLE_UPDATE_SINK_H_
+
+#include <vector>
+
+// Receives vehicle updates right from the protocol decoder, so no intermediate VehicleUpdate objects are created
+class VehicleUpdateSink {
+public:
+    virtual void applyVehicleUpdate(long long id, double x, double y, int durability, int remainingAttackCooldownTicks,
+                                    bool selected, const std::vector<int>& groups) = 0;
+
+    virtual ~VehicleUpdateSink() { }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include "geometry.h"
+
+struct VehicleGroup;
+
+// What a goal step waits for. A goal whose step didn't proceed sleeps until its condition fires,
+// see GoalScheduler. Steps without a condition are polled every tick
+struct WakeCondition
+{
+    enum class Type
+    {
+        eNONE = 0,
+        eTICK,             // tick index reached
+        eACTION_POINT,     // player may act
+        eGROUP_STOPS,      // group rect and center didn't change since previous tick
+        eGROUP_AT_POINT,   // group center is exactly at the point
+    };
+
+    Type                m_type  = Type::eNONE;
+    int                 m_tick  = 0;
+    const VehicleGroup* m_group = nullptr;
+    Point               m_point;
+
+    static WakeCondition none()                                                 { return WakeCondition(); }
+    static WakeCondition atTick(int tick)                                       { WakeCondition c; c.m_type = Type::eTICK; c.m_tick = tick; return c; }
+    static WakeCondition actionPoint()                                          { WakeCondition c; c.m_type = Type::eACTION_POINT; return c; }
+    static WakeCondition groupStops(const VehicleGroup& group)                  { WakeCondition c; c.m_type = Type::eGROUP_STOPS; c.m_group = &group; return c; }
+    static WakeCondition groupAt(const VehicleGroup& group, const Point& point) { WakeCondition c; c.m_type = Type::eGROUP_AT_POINT; c.m_group = &group; c.m_point = point; return c; }
+};
+
+// condition implied by the type of step's 'should proceed' callable. Waiting helpers from goalUtils.h
+// provide overloads, found by argument dependent lookup; anything else is polled
+template <typename ShouldProceed>
+WakeCondition wakeConditionOf(const ShouldProceed&)
+{
+    return WakeCondition::none();
+}
@@ -716,7 +716,7 @@ bool CSimpleSocket::SetOptionLinger(bool bEnable, uint16 nTime)
 //             of scope.                                                    
 //                                                                          
 //------------------------------------------------------------------------------
-int32 CSimpleSocket::Receive(int32 nMaxBytes)
+int32 CSimpleSocket::Receive(int32 nMaxBytes, uint8 *pBuffer)
 {
     m_nBytesReceived = 0;
 
@@ -728,23 +728,30 @@ int32 CSimpleSocket::Receive(int32 nMaxBytes)
         return m_nBytesReceived;
     }
 
-    //--------------------------------------------------------------------------
-    // Free existing buffer and allocate a new buffer the size of
-    // nMaxBytes.
-    //--------------------------------------------------------------------------
-    if ((m_pBuffer != NULL) && (nMaxBytes != m_nBufferSize))
-    {
-        delete [] m_pBuffer;
-        m_pBuffer = NULL;
-    }
+    uint8 *pWorkBuffer = pBuffer;
 
-    //--------------------------------------------------------------------------
-    // Allocate a new internal buffer to receive data.
-    //--------------------------------------------------------------------------
-    if (m_pBuffer == NULL)
+    if (pWorkBuffer == NULL)
     {
-        m_nBufferSize = nMaxBytes;
-        m_pBuffer = new uint8[nMaxBytes]; 
+        //----------------------------------------------------------------------
+        // Free existing buffer and allocate a new buffer the size of
+        // nMaxBytes.
+        //----------------------------------------------------------------------
+        if ((m_pBuffer != NULL) && (nMaxBytes != m_nBufferSize))
+        {
+            delete [] m_pBuffer;
+            m_pBuffer = NULL;
+        }
+
+        //----------------------------------------------------------------------
+        // Allocate a new internal buffer to receive data.
+        //----------------------------------------------------------------------
+        if (m_pBuffer == NULL)
+        {
+            m_nBufferSize = nMaxBytes;
+            m_pBuffer = new uint8[nMaxBytes]; 
+        }
+
+        pWorkBuffer = m_pBuffer;
     }
 
     SetSocketError(SocketSuccess);
@@ -762,7 +769,7 @@ int32 CSimpleSocket::Receive(int32 nMaxBytes)
         {
             do 
             {
-                m_nBytesReceived = RECV(m_socket, (m_pBuffer + m_nBytesReceived), 
+                m_nBytesReceived = RECV(m_socket, (pWorkBuffer + m_nBytesReceived), 
                                         nMaxBytes, m_nFlags);
                 TranslateSocketError();
             } while ((GetSocketError() == CSimpleSocket::SocketInterrupted));
@@ -779,7 +786,7 @@ int32 CSimpleSocket::Receive(int32 nMaxBytes)
             {
                 do 
                 {
-                    m_nBytesReceived = RECVFROM(m_socket, m_pBuffer, nMaxBytes, 0, 
+                    m_nBytesReceived = RECVFROM(m_socket, pWorkBuffer, nMaxBytes, 0, 
                                                 &m_stMulticastGroup, &srcSize);
                     TranslateSocketError();
                 } while (GetSocketError() == CSimpleSocket::SocketInterrupted);
@@ -788,7 +795,7 @@ int32 CSimpleSocket::Receive(int32 nMaxBytes)
             {
                 do 
                 {
-                    m_nBytesReceived = RECVFROM(m_socket, m_pBuffer, nMaxBytes, 0, 
+                    m_nBytesReceived = RECVFROM(m_socket, pWorkBuffer, nMaxBytes, 0, 
                                                 &m_stClientSockaddr, &srcSize);
                     TranslateSocketError();
                 } while (GetSocketError() == CSimpleSocket::SocketInterrupted);
@@ -811,7 +818,7 @@ int32 CSimpleSocket::Receive(int32 nMaxBytes)
     //--------------------------------------------------------------------------
     if (m_nBytesReceived == CSimpleSocket::SocketError)
     {
-        if (m_pBuffer != NULL)
+        if ((pBuffer == NULL) && (m_pBuffer != NULL))
         {
             delete [] m_pBuffer;
             m_pBuffer = NULL;
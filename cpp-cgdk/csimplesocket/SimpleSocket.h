@@ -201,10 +201,13 @@ public:
 
     /// Attempts to receive a block of data on an established connection.   
     /// @param nMaxBytes maximum number of bytes to receive.
+    /// @param pBuffer optional caller-owned memory block of at least nMaxBytes
+    /// to receive into. When NULL, data goes to the internal buffer which is
+    /// available through GetData().
     /// @return number of bytes actually received.
     /// @return of zero means the connection has been shutdown on the other side.
     /// @return of -1 means that an error has occurred.
-    virtual int32 Receive(int32 nMaxBytes = 1);
+    virtual int32 Receive(int32 nMaxBytes = 1, uint8 *pBuffer = NULL);
 
     /// Attempts to send a block of data on an established connection.
     /// @param pBuf block of data to be sent.
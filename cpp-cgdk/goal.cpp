@@ -1,6 +1,12 @@
 #include "goal.h"
 #include "goalManager.h"
 
+Goal::~Goal()
+{
+    if (m_isSleeping)
+        m_goalManager.scheduler().cancel(this);
+}
+
 void Goal::performStep(GoalManager& goalManager, bool isBackgroundMode)
 {
     if (checkNuclearLaunch())
@@ -9,29 +15,47 @@ void Goal::performStep(GoalManager& goalManager, bool isBackgroundMode)
     if (isFinished())
         return;
 
-    const Step* currentStep = m_steps.front().get();
-    if (currentStep->m_shouldAbort())
+    const Step* currentStep = &m_steps.front();
+    if (currentStep->m_shouldAbort())   // cheap, so checked while sleeping too
     {
+        if (m_isSleeping)
+            goalManager.scheduler().cancel(this);
+
+        m_isSleeping = false;
         abortGoal();
         return;
     }
 
-    if (currentStep->m_shouldProceed())
+    // sleeping step would not proceed anyway, only multitasking is possible
+    if (!m_isSleeping)
     {
-        if (currentStep->m_proceed())
+        // the scheduler has just seen the condition fire. Stateful checks like WaitUntilStops compare with what they saw
+        // before the sleep, so asking them would cost one more tick
+        const bool isWoken = m_wakeTick == m_state.world()->getTickIndex();
+        m_wakeTick = -1;
+
+        if (isWoken || currentStep->m_shouldProceed())
         {
-            m_isStarted = true;
-            currentStep = nullptr;
-            m_steps.pop_front();
+            if (currentStep->m_proceed())
+            {
+                m_isStarted = true;
+                currentStep = nullptr;
+                m_steps.popFront();
 
-            // proceed with next step is this one just finished without move
-            if (isNoMoveComitted())
-                performStep(goalManager, isBackgroundMode);
+                // proceed with next step is this one just finished without move
+                if (isNoMoveComitted())
+                    performStep(goalManager, isBackgroundMode);
+            }
+            else
+            {
+                abortGoal();
+                return;
+            }
         }
-        else
+        else if (currentStep == &m_steps.front())
         {
-            abortGoal();
-            return;
+            // the step may have pushed another one in front of itself, which has to be polled
+            m_isSleeping = goalManager.scheduler().sleep(this, currentStep->m_wake, m_state);
         }
     }
 
@@ -42,7 +66,7 @@ void Goal::performStep(GoalManager& goalManager, bool isBackgroundMode)
 
 void Goal::doMultitasking(GoalManager& goalManager)
 {
-    if(isNoMoveComitted() && !m_steps.empty() && m_steps.front()->m_isMultitaskPoint)
+    if(isNoMoveComitted() && !m_steps.empty() && m_steps.front().m_isMultitaskPoint)
     {
         // not yet ready for current step, do something else
         goalManager.doMultitasking(this);
@@ -56,134 +80,15 @@ bool Goal::isNoMoveComitted()
 
 bool Goal::checkNuclearLaunch()
 {
-    static const double LOOKUP_RANGE = 10 * m_state.game()->getFighterSpeed() + m_state.game()->getFighterVisionRange() 
-                                          + m_state.game()->getTacticalNuclearStrikeRadius();
+    // target is chosen by State once per tick, goals only launch it
+    const NukePlanner& planner = m_state.nukePlanner();
 
     if (!m_state.isMoveCommitted()
-        && m_state.getDistanceToAlliensRect() < LOOKUP_RANGE
-        && m_state.player()->getRemainingNuclearStrikeCooldownTicks() == 0)
+        && m_state.player()->getRemainingNuclearStrikeCooldownTicks() == 0
+        && planner.hasTarget())
     {
-        const auto& allVehicles = state().getAllVehicles();
-
-        Rect reachableRect = state().getTeammatesRect().inflate(LOOKUP_RANGE);
-
-        std::map<double, VehiclePtr> nukeDamageMap;
-
-        std::vector<VehiclePtr> teammates;
-        std::vector<VehiclePtr> reachangeAlliens;
-        teammates.reserve(allVehicles.size());
-        reachangeAlliens.reserve(allVehicles.size());
-
-        const model::Player& enemyPlayer = *state().enemy();
-        Point enemyNuke = state().enemyNuclearMissileTarget();
-        int   ticksToEnemyNuke = enemyPlayer.getNextNuclearStrikeTickIndex() != -1 ? enemyPlayer.getNextNuclearStrikeTickIndex() - state().world()->getTickIndex() : 0;
-
-        const double nukeRadius        = m_state.game()->getTacticalNuclearStrikeRadius();
-        const double maxPossibleDamage = m_state.game()->getMaxTacticalNuclearStrikeDamage();
-        const auto   myPlayerId        = m_state.player()->getId();
-        const double decaySpeed        = nukeRadius / maxPossibleDamage;
-
-        auto getDamage = [decaySpeed, maxPossibleDamage, myPlayerId](const Point& hitPoint, const model::Vehicle& unit, double teammateDamageFactor = -1.5)
-        {
-            double real   = std::max(0.0, maxPossibleDamage - (hitPoint.getDistanceTo(unit) / decaySpeed));   // TODO - check!
-            double damage = real >= unit.getDurability() ? unit.getMaxDurability() : real;
-
-            return (unit.getPlayerId() == myPlayerId ? teammateDamageFactor : 1.0) * real;
-        };
-
-
-        for (const std::pair<long long, VehiclePtr>& idVehiclePair : allVehicles)
-        {
-            const VehiclePtr& vehicle = idVehiclePair.second;
-
-            if (vehicle->getPlayerId() == state().player()->getId())
-                teammates.push_back(vehicle);
-            else if (reachableRect.contains(*vehicle))
-                reachangeAlliens.push_back(vehicle);
-        }
-
-        static const double MIN_HEALTH = 0.5 * 100;    // TODO - remove hardcode
-        static const double MIN_DAMAGE = 90;
-
-        for (const VehiclePtr& teammate : teammates)
-        {
-            const double enemyNukeDamage = enemyNuke != Point() ? getDamage(enemyNuke, *teammate, 1.0) + ticksToEnemyNuke / 2 : 0;
-            const double healthThreshold = std::max(MIN_HEALTH, enemyNukeDamage);
-            if (teammate->getDurability() <= healthThreshold)
-                continue;   // teammate is about to go :(
-
-            double damage = 0;
-            double sqaredVr = teammate->getSquaredVisionRange();
-
-            for (const VehiclePtr& enemy : reachangeAlliens)
-                if (teammate->getSquaredDistanceTo(*enemy) < sqaredVr)
-                    damage += enemy->getDurability() * (enemy->getDurability() > MIN_HEALTH ? 1 : 2);
-
-            if (damage >= MIN_DAMAGE)
-                nukeDamageMap[damage] = teammate;
-        }
-
-        struct DamageInfo
-        {
-            Point      m_point;
-            double     m_damage;
-            VehiclePtr m_guide;
-
-            DamageInfo(const Point& p, double damage, const VehiclePtr& guide) : m_point(p), m_damage(damage), m_guide(guide) {}
-        };
-
-        static const int LOOKUP_ITEMS_LIMIT = 50;
-        std::vector<DamageInfo> targets;
-        targets.reserve(LOOKUP_ITEMS_LIMIT);
-
-        int lookupItemsLeft = LOOKUP_ITEMS_LIMIT;
-        for (auto itDamage = nukeDamageMap.rbegin(); itDamage != nukeDamageMap.rend() && lookupItemsLeft > 0; ++itDamage, --lookupItemsLeft)
-        {
-            auto teammate = itDamage->second;
-
-            DamageInfo bestDamage{ Point(), 0, teammate };
-
-            // TODO - predict terrain where this unit will go next 30 ticks!
-
-            double rangeGap = teammate->getRadius();
-            double visionRange = state().getUnitVisionRange(*teammate) - 2 * teammate->getRadius() - rangeGap; 
-            double squaredVR = visionRange * visionRange;
-
-            // TODO - add hitpoints in the middle of alliens or something similar
-
-            for (const VehiclePtr& hitPoint : reachangeAlliens)
-            {
-                if (teammate->getSquaredDistanceTo(*hitPoint) > squaredVR)
-                    continue;
-
-                double damage = 0;
-                for (const VehiclePtr& enemy : reachangeAlliens)
-                    damage += getDamage(*hitPoint, *enemy);
-
-                for (const VehiclePtr& friendly : teammates)
-                    damage += getDamage(*hitPoint, *friendly);
-
-                if (bestDamage.m_damage < damage)
-                {
-                    bestDamage.m_damage = damage;
-                    bestDamage.m_point = *hitPoint;
-                }
-            }
-
-            if (bestDamage.m_damage > 0)
-                targets.emplace_back(bestDamage);
-        }
-
-        // pre-sort DESC by guide durability
-        std::sort(targets.begin(), targets.end(), [](const DamageInfo& a, const DamageInfo& b) { return a.m_guide->getDurability() > b.m_guide->getDurability(); });
-
-        // sort DESC by damage
-        std::stable_sort(targets.begin(), targets.end(), [](const DamageInfo& a, const DamageInfo& b) { return a.m_damage > b.m_damage; });
-
-        if (!targets.empty())
-        {
-            state().setNukeAction(targets.front().m_point, *targets.front().m_guide);
-        }
+        const NukePlanner::Target& target = planner.bestTarget();
+        state().setNukeAction(target.m_point, state().getAllVehicles().vehicle(target.m_guide));
     }
 
     return m_state.isMoveCommitted();
@@ -1,14 +1,15 @@
 #pragma once
 #include <memory>
-#include <functional>
-#include <list>
 #include "forwardDeclarations.h"
 #include "state.h"
+#include "InplaceCallback.h"
+#include "StepList.h"
+#include "WakeCondition.h"
 
 class Goal
 {
 protected:
-    typedef std::function<bool()> Callback;
+    typedef InplaceCallback Callback;
 
     enum class StepType
     {
@@ -18,28 +19,16 @@ protected:
     };
 
 private:
-    struct Step;
-    typedef std::unique_ptr<Step> StepPtr;
+    typedef GoalStep Step;
 
-    struct Step
-    {
-        const char* m_debugName;
-
-        Callback    m_shouldAbort;
-        Callback    m_shouldProceed;
-        Callback    m_proceed;
-        bool        m_isMultitaskPoint;
-
-        Step(Callback shouldAbort, Callback shouldProceed, Callback proceed, const char* debugName = nullptr, StepType type = StepType::ATOMIC)
-            : m_shouldAbort(shouldAbort), m_shouldProceed(shouldProceed), m_proceed(proceed), m_debugName(debugName)
-            , m_isMultitaskPoint(type == StepType::ALLOW_MULTITASK) 
-        {}
-    };
-
-    std::list<StepPtr> m_steps;
+    StepList           m_steps;
     GoalManager&       m_goalManager;
     State&             m_state;
     bool               m_isStarted;
+    bool               m_isSleeping = false;    // current step waits for its wake condition, see GoalScheduler
+    int                m_wakeTick   = -1;       // tick the wake condition fired at, the step proceeds without asking then
+
+    friend class GoalScheduler;
 
 
     void abortGoal() { m_steps.clear(); }
@@ -53,28 +42,28 @@ private:
 
 protected:
 
-    template <typename... Args>
-    void pushBackStep(Args&&... args)
+    template <typename Abort, typename Proceed, typename Action>
+    void pushBackStep(Abort&& shouldAbort, Proceed&& shouldProceed, Action&& proceed, const char* debugName = nullptr, StepType type = StepType::ATOMIC)
     {
-        return m_steps.emplace_back(std::make_unique<Step>(std::forward<Args>(args)...));
+        const WakeCondition wake = wakeConditionOf(shouldProceed);
+        m_steps.emplaceBack(Callback(std::forward<Abort>(shouldAbort)), Callback(std::forward<Proceed>(shouldProceed)), Callback(std::forward<Action>(proceed)),
+                            debugName, type == StepType::ALLOW_MULTITASK, wake);
     }
 
-    template <typename... Args>
-    void pushNextStep(Args&&... args)
+    template <typename Abort, typename Proceed, typename Action>
+    void pushNextStep(Abort&& shouldAbort, Proceed&& shouldProceed, Action&& proceed, const char* debugName = nullptr, StepType type = StepType::ATOMIC)
     {
-        if (m_steps.empty())
-            pushBackStep(std::forward<Args>(args)...);
-        else
-            m_steps.emplace(++m_steps.begin(), std::make_unique<Step>(std::forward<Args>(args)...));
+        const WakeCondition wake = wakeConditionOf(shouldProceed);
+        m_steps.emplaceSecond(Callback(std::forward<Abort>(shouldAbort)), Callback(std::forward<Proceed>(shouldProceed)), Callback(std::forward<Action>(proceed)),
+                              debugName, type == StepType::ALLOW_MULTITASK, wake);
     }
 
-    template <typename... Args>
-    void pushFirstStep(Args&&... args)
+    template <typename Abort, typename Proceed, typename Action>
+    void pushFirstStep(Abort&& shouldAbort, Proceed&& shouldProceed, Action&& proceed, const char* debugName = nullptr, StepType type = StepType::ATOMIC)
     {
-        if(m_steps.empty())
-            pushBackStep(std::forward<Args>(args)...);
-        else
-            m_steps.emplace_front(std::make_unique<Step>(std::forward<Args>(args)...));
+        const WakeCondition wake = wakeConditionOf(shouldProceed);
+        m_steps.emplaceFront(Callback(std::forward<Abort>(shouldAbort)), Callback(std::forward<Proceed>(shouldProceed)), Callback(std::forward<Action>(proceed)),
+                             debugName, type == StepType::ALLOW_MULTITASK, wake);
     }
 
 
@@ -92,21 +81,22 @@ protected:
     const VehicleGroup& allienHelicopters() const { return m_state.alliens(model::VehicleType::HELICOPTER); }
     const VehicleGroup& allienTanks()       const { return m_state.alliens(model::VehicleType::TANK); }
 
-    bool isAboutToAbort() const                   { return m_steps.size() == 1 && m_steps.front()->m_shouldAbort(); }
+    bool isAboutToAbort() const                   { return m_steps.size() == 1 && m_steps.front().m_shouldAbort(); }
 
 public:
 
     Goal(State& state, GoalManager& goalManager) : m_goalManager(goalManager), m_state(state), m_isStarted(false) {}
-    virtual ~Goal()                                         {}
+    virtual ~Goal();
 
     bool isFinished() const              { return m_steps.empty(); }
     bool isStarted() const               { return m_isStarted; }
-    bool canPause() const                { return isFinished() || !isStarted() || m_steps.front()->m_isMultitaskPoint; }
+    bool isSleeping() const              { return m_isSleeping; }
+    bool canPause() const                { return isFinished() || !isStarted() || m_steps.front().m_isMultitaskPoint; }
 
     bool isEligibleForBackgroundMode(const Goal* interrupted) 
     { 
         // ensure it will return execution
-        bool hasMultitaskPoint = std::find_if(m_steps.begin(), m_steps.end(), [](const StepPtr& step) { return step->m_isMultitaskPoint; }) != m_steps.end();
+        bool hasMultitaskPoint = m_steps.any([](const Step& step) { return step.m_isMultitaskPoint; });
 
         return this != interrupted && hasMultitaskPoint && isCompatibleWith(interrupted); 
     }
@@ -9,30 +9,48 @@
 #include "GoalProduceVehicles.h"
 #include "state.h"
 
-void GoalManager::fillCurrentGoals()
+// goals are kept sorted by priority DESC, so the most priority one lives at back()
+static bool isMorePriority(const GoalManager::GoalHolder& left, const GoalManager::GoalHolder& right)
 {
-    // use sorted list because std::multimap looks like overengieneering
+    return right < left;
+}
 
+void GoalManager::insertCurrentGoal(GoalHolder&& holder)
+{
+    auto position = std::upper_bound(m_currentGoals.begin(), m_currentGoals.end(), holder, isMorePriority);
+    m_currentGoals.insert(position, std::move(holder));
+}
+
+void GoalManager::eraseCurrentGoal(const Goal* goal, int priority)
+{
+    auto it = std::lower_bound(m_currentGoals.begin(), m_currentGoals.end(), priority, [goal](const GoalHolder& holder, int priority)
+    {
+        return GoalHolder::isBefore(priority, goal, holder.m_priority, holder.m_goal.get());
+    });
+
+    assert(it != m_currentGoals.end() && it->m_goal.get() == goal);
+    m_currentGoals.erase(it);
+}
+
+void GoalManager::fillCurrentGoals()
+{
     if (m_state.world()->getTickIndex() == 0)
     {
         int priority = 0;
-        int backPriority = 256;
 
-        m_currentGoals.emplace_back(priority++, std::make_unique<goals::MixTanksAndHealers>(m_state, *this));
-        m_currentGoals.emplace_back(priority++, std::make_unique<goals::DefendHelicoptersFromRush>(m_state, *this));
-        m_currentGoals.emplace_back(priority++, std::make_unique<goals::GoalDefendTank>(m_state, *this));
-        m_currentGoals.emplace_back(priority++, std::make_unique<goals::GoalDefendIfv>(m_state, *this));
+        insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::MixTanksAndHealers>(m_state, *this)));
+        insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::DefendHelicoptersFromRush>(m_state, *this)));
+        insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::GoalDefendTank>(m_state, *this)));
+        insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::GoalDefendIfv>(m_state, *this)));
 
         if (m_state.areFacilitiesEnabled())
         {
-            m_currentGoals.emplace_back(priority++, std::make_unique<goals::ProduceVehicles>(m_state, *this));
-            m_currentGoals.emplace_back(priority++, std::make_unique<goals::CaptureNearFacility>(m_state, *this));
-            m_currentGoals.emplace_back(priority++, std::make_unique<goals::DefendCapturers>(m_state, *this));
+            insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::ProduceVehicles>(m_state, *this)));
+            insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::CaptureNearFacility>(m_state, *this)));
+            insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::DefendCapturers>(m_state, *this)));
         }
         
-        m_currentGoals.emplace_back(priority++, std::make_unique<goals::RushWithAircraft>(m_state, *this));
-
-        m_currentGoals.sort();
+        insertCurrentGoal(GoalHolder(priority++, std::make_unique<goals::RushWithAircraft>(m_state, *this)));
     }
 
     if (!m_waitingInsetrion.empty())
@@ -43,18 +61,18 @@ void GoalManager::fillCurrentGoals()
 
         if (!isManagerBusy)
         {
-            m_currentGoals.splice(m_currentGoals.end(), m_waitingInsetrion);
-        }
+            for (GoalHolder& holder : m_waitingInsetrion)
+                insertCurrentGoal(std::move(holder));
 
-        m_currentGoals.sort();
+            m_waitingInsetrion.clear();
+        }
     }
-
-    assert(std::is_sorted(m_currentGoals.begin(), m_currentGoals.end()) && "please keep goals sorted by-priority");
 }
 
 GoalManager::GoalManager(State& state) 
     : m_state(state)
     , m_forcedGoal(nullptr)
+    , m_forcedPriority(0)
 {
 
 }
@@ -71,6 +89,7 @@ struct NukeGoal : public Goal
 void GoalManager::tick()
 {
     fillCurrentGoals();
+    m_scheduler.update(m_state);
 
     if (m_forcedGoal)
     {
@@ -78,12 +97,8 @@ void GoalManager::tick()
 
         if (m_forcedGoal->isFinished())
         {
-            auto forcedIt = std::find_if(m_currentGoals.begin(), m_currentGoals.end(), 
-                [this](const GoalHolder& holder) { return holder.m_goal.get() == m_forcedGoal; });
-            assert(forcedIt != m_currentGoals.end());
-
+            eraseCurrentGoal(m_forcedGoal, m_forcedPriority);
             m_forcedGoal = nullptr;           // done, pause and remove
-            m_currentGoals.erase(forcedIt);
         }
 
         if (m_forcedGoal && m_forcedGoal->canPause())
@@ -94,14 +109,17 @@ void GoalManager::tick()
     {
         if (!m_currentGoals.empty())
         {
-            const GoalPtr& mostPriority = m_currentGoals.front().m_goal;
+            // multitasking may purge other goals and shift this one, so don't hold a reference into the vector
+            Goal*     mostPriority = m_currentGoals.back().m_goal.get();
+            const int priority     = m_currentGoals.back().m_priority;
+
             mostPriority->performStep(*this, false);
             if (mostPriority->isFinished())
             {
-                if (m_forcedGoal == m_currentGoals.front().m_goal.get())
+                if (m_forcedGoal == mostPriority)
                     m_forcedGoal = nullptr;
 
-                m_currentGoals.pop_front();
+                eraseCurrentGoal(mostPriority, priority);
             }
         }
         else
@@ -110,30 +128,48 @@ void GoalManager::tick()
             dummy.performStep(*this, false);
         }
     }
+
+    // nobody needs the action point, spend it on control groups to save actions later
+    if (!m_state.isMoveCommitted() && m_state.hasActionPoint() && m_state.actionBudget().canSpend(BACKGROUND_ACTION_RESERVE))
+        m_state.maintainControlGroups();
 }
 
 void GoalManager::doMultitasking(const Goal* interruptedGoal)
 {
-    Goal* executedGoal = nullptr;
+    // background goals may not spend the last actions of the window, the interrupted goal will need them soon
+    if (!m_state.actionBudget().canSpend(BACKGROUND_ACTION_RESERVE))
+        return;
 
-    for (const GoalHolder& goalHolder : m_currentGoals)
+    const GoalHolder* executedGoal = nullptr;
+    bool              anyFinished  = false;
+
+    for (auto it = m_currentGoals.rbegin(); it != m_currentGoals.rend(); ++it)
     {
-        const GoalPtr& goal = goalHolder.m_goal;
+        const GoalPtr& goal = it->m_goal;
         if (!goal->isEligibleForBackgroundMode(interruptedGoal))
             continue;
 
         goal->performStep(*this, true);
+        anyFinished = anyFinished || goal->isFinished();
+
         if (m_state.isMoveCommitted())
         {
-            executedGoal = goal.get();
+            executedGoal = &*it;
             break;   // one tick - one move
         }
     }
 
-    if (executedGoal && !executedGoal->isFinished() && !executedGoal->canPause())
-        m_forcedGoal = executedGoal;
+    if (executedGoal && !executedGoal->m_goal->isFinished() && !executedGoal->m_goal->canPause())
+    {
+        m_forcedGoal     = executedGoal->m_goal.get();
+        m_forcedPriority = executedGoal->m_priority;
+    }
 
     // purge finished goals
-    m_currentGoals.remove_if([](const GoalHolder& holder) { return holder.m_goal->isFinished(); });
+    if (anyFinished)
+    {
+        m_currentGoals.erase(std::remove_if(m_currentGoals.begin(), m_currentGoals.end(),
+            [](const GoalHolder& holder) { return holder.m_goal->isFinished(); }), m_currentGoals.end());
+    }
 }
 
@@ -1,5 +1,5 @@
 #pragma once
-#include <list>
+#include <vector>
 #include <memory>
 
 #include "model/Player.h"
@@ -9,6 +9,7 @@
 
 #include "forwardDeclarations.h"
 #include "goal.h"
+#include "GoalScheduler.h"
 
 class GoalManager
 {
@@ -17,28 +18,39 @@ public:
 
     struct GoalHolder
     {
-        const int m_priority;
-        GoalPtr   m_goal;
+        int     m_priority;
+        GoalPtr m_goal;
 
         GoalHolder(int priority, GoalPtr&& goal) : m_priority(priority), m_goal(std::move(goal)) {}
 
-        bool operator<(const GoalHolder& right)
+        bool operator<(const GoalHolder& right) const
         {
-            return m_priority < right.m_priority
-                || (m_priority == right.m_priority && m_goal.get() < right.m_goal.get());
+            return isBefore(m_priority, m_goal.get(), right.m_priority, right.m_goal.get());
+        }
+
+        static bool isBefore(int priority, const Goal* goal, int rightPriority, const Goal* rightGoal)
+        {
+            return priority < rightPriority || (priority == rightPriority && goal < rightGoal);
         }
     };
 
-    typedef std::list<GoalHolder> Goals;
+    // sorted by priority DESC, so the most priority goal is the last one
+    typedef std::vector<GoalHolder> Goals;
 
 private:
 
-    State& m_state;
+    static const int BACKGROUND_ACTION_RESERVE = 1;   // actions left in the window for the most priority goal
+
+    State&        m_state;
+    GoalScheduler m_scheduler;    // goals refer to it until destroyed, so it's declared before them
     Goals  m_currentGoals;
     Goal*  m_forcedGoal;
+    int    m_forcedPriority;
     Goals  m_waitingInsetrion;
 
     void fillCurrentGoals();
+    void insertCurrentGoal(GoalHolder&& holder);
+    void eraseCurrentGoal(const Goal* goal, int priority);
 
 public:
     explicit GoalManager(State& state);
@@ -49,6 +61,7 @@ public:
     void insertGoal(int priority, GoalPtr&& goal)                  { m_waitingInsetrion.emplace_back(priority, std::move(goal)); }
 
     const Goals& currentGoals() const                              { return m_currentGoals; }
+    GoalScheduler& scheduler()                                     { return m_scheduler; }
 };
 
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "VehicleGroup.h"
 #include "state.h"
+#include "WakeCondition.h"
 
 namespace goals
 {
@@ -13,6 +14,8 @@ namespace goals
     public:
         explicit WaitUntilStops(const VehicleGroup& group) : m_group(group), m_previousRect(Point(-1, -1), Point(-1, -1)) {}
 
+        const VehicleGroup& group() const { return m_group; }
+
         bool operator()()
         {
             bool isStopped = m_previousRect == m_group.m_rect && m_previousCenter == m_group.m_center;
@@ -44,7 +47,24 @@ namespace goals
             : m_state(state), m_stopTick(state.world()->getTickIndex() + ticksToWait)       {}
 
         bool operator()() const       { return m_state.world()->getTickIndex() >= m_stopTick; }
+        int  stopTick() const         { return m_stopTick; }
     };
 
+    class HasActionPoint
+    {
+        const State& m_state;
+
+    public:
+        explicit HasActionPoint(const State& state) : m_state(state) {}
+
+        bool operator()() const       { return m_state.hasActionPoint(); }
+    };
+
+    // sleeping conditions of the waiters above, see GoalScheduler
+    inline WakeCondition wakeConditionOf(const WaitUntilStops& waiter)  { return WakeCondition::groupStops(waiter.group()); }
+    inline WakeCondition wakeConditionOf(const WaitMove& waiter)        { return WakeCondition::groupAt(waiter.group, waiter.destination); }
+    inline WakeCondition wakeConditionOf(const WaitSomeTicks& waiter)   { return WakeCondition::atTick(waiter.stopTick()); }
+    inline WakeCondition wakeConditionOf(const HasActionPoint&)         { return WakeCondition::actionPoint(); }
+
 }
 
@@ -0,0 +1,248 @@
+// Stand-in for the local runner: serves a session captured by RemoteProcessClient::startCapture() to a strategy
+// connected over TCP and measures PLAYER_CONTEXT -> MOVE round trip of every tick.
+//
+// usage: LoopbackServer capture.bin [--port 31001] [--nagle] [--quickack] [--sndbuf bytes] [--rcvbuf bytes]
+//        then run: MyStrategy 127.0.0.1 31001 0000000000000000
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if !defined(WIN32) && !defined(_WIN32)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+#include "../csimplesocket/PassiveSocket.h"
+#include "../MappedFile.h"
+#include "../RemoteProcessClient.h"
+
+using namespace std;
+
+namespace {
+
+const int MOVE_MESSAGE_PAYLOAD_SIZE = 1 + 1 + 4 + 10 * 8 + 1 + 2 * 8;   // flag, action, group, 10 doubles, type, 2 ids
+
+struct Options {
+    string capturePath;
+    int port = 31001;
+    bool nagle = false;
+    bool quickAck = false;
+    int sendBufferSize = 0;
+    int receiveBufferSize = 0;
+};
+
+struct Message {
+    size_t begin;
+    size_t end;
+};
+
+struct Session {
+    Message greeting;                 // TEAM_SIZE and GAME_CONTEXT
+    vector<Message> playerContexts;
+};
+
+void printUsage() {
+    printf("usage: LoopbackServer capture.bin [--port N] [--nagle] [--quickack] [--sndbuf bytes] [--rcvbuf bytes]\n");
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    if (argc < 2) {
+        return false;
+    }
+
+    options.capturePath = argv[1];
+
+    for (int i = 2; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--port") == 0 && hasValue) {
+            options.port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--nagle") == 0) {
+            options.nagle = true;
+        } else if (strcmp(argv[i], "--quickack") == 0) {
+            options.quickAck = true;
+        } else if (strcmp(argv[i], "--sndbuf") == 0 && hasValue) {
+            options.sendBufferSize = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rcvbuf") == 0 && hasValue) {
+            options.receiveBufferSize = atoi(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// split the captured byte stream into messages by decoding it the same way the strategy does
+Session splitSession(const string& capturePath, size_t captureSize) {
+    RemoteProcessClient decoder(capturePath);
+    Session session;
+
+    decoder.readTeamSizeMessage();
+    decoder.readGameContextMessage();
+    session.greeting = Message{ 0, decoder.getConsumedByteCount() };
+
+    while (decoder.getConsumedByteCount() < captureSize) {
+        size_t begin = decoder.getConsumedByteCount();
+        if (decoder.readPlayerContextMessage() == nullptr) {
+            break;
+        }
+
+        session.playerContexts.push_back(Message{ begin, decoder.getConsumedByteCount() });
+    }
+
+    return session;
+}
+
+void setQuickAck(CActiveSocket& socket, const Options& options) {
+#ifdef TCP_QUICKACK
+    if (options.quickAck) {
+        int enable = 1;
+        setsockopt(socket.GetSocketDescriptor(), IPPROTO_TCP, TCP_QUICKACK, &enable, sizeof(enable));
+    }
+#endif
+}
+
+void applyOptions(CActiveSocket& socket, const Options& options) {
+    if (options.nagle) {
+        socket.EnableNagleAlgoritm();
+    } else {
+        socket.DisableNagleAlgoritm();
+    }
+
+    if (options.sendBufferSize > 0) {
+        setsockopt(socket.GetSocketDescriptor(), SOL_SOCKET, SO_SNDBUF,
+            reinterpret_cast<const char*>(&options.sendBufferSize), sizeof(options.sendBufferSize));
+    }
+
+    if (options.receiveBufferSize > 0) {
+        setsockopt(socket.GetSocketDescriptor(), SOL_SOCKET, SO_RCVBUF,
+            reinterpret_cast<const char*>(&options.receiveBufferSize), sizeof(options.receiveBufferSize));
+    }
+
+    setQuickAck(socket, options);
+}
+
+void send(CActiveSocket& socket, const signed char* data, size_t byteCount) {
+    size_t offset = 0;
+    int sentByteCount;
+
+    while (offset < byteCount
+        && (sentByteCount = socket.Send(reinterpret_cast<const uint8*>(data + offset), byteCount - offset)) > 0) {
+        offset += sentByteCount;
+    }
+
+    if (offset != byteCount) {
+        printf("client disconnected\n");
+        exit(1);
+    }
+}
+
+void expectMessage(ReadBuffer& input, MessageType expectedType) {
+    MessageType actualType = static_cast<MessageType>(*input.read(1));
+    if (actualType != expectedType) {
+        printf("unexpected message type %d, expected %d\n", static_cast<int>(actualType), static_cast<int>(expectedType));
+        exit(1);
+    }
+}
+
+int readInt(ReadBuffer& input) {
+    int value;
+    memcpy(&value, input.read(sizeof(value)), sizeof(value));
+    return value;
+}
+
+double percentile(const vector<double>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+void printStats(vector<double> latencies) {
+    if (latencies.empty()) {
+        printf("no ticks served\n");
+        return;
+    }
+
+    double total = 0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+
+    sort(latencies.begin(), latencies.end());
+
+    printf("ticks: %zu, total: %.1f ms\n", latencies.size(), total / 1000);
+    printf("round trip, us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n", percentile(latencies, 0.5),
+        percentile(latencies, 0.9), percentile(latencies, 0.99), latencies.back());
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    MappedFile capture;
+    if (!capture.open(options.capturePath)) {
+        printf("can't open %s\n", options.capturePath.c_str());
+        return 1;
+    }
+
+    Session session = splitSession(options.capturePath, capture.getSize());
+    printf("loaded %zu ticks from %s\n", session.playerContexts.size(), options.capturePath.c_str());
+
+    CPassiveSocket server;
+    server.Initialize();
+    if (!server.Listen(reinterpret_cast<const uint8*>("127.0.0.1"), static_cast<int16>(options.port))) {
+        printf("can't listen on port %d\n", options.port);
+        return 1;
+    }
+
+    unique_ptr<CActiveSocket> client(server.Accept());
+    if (client == nullptr) {
+        printf("accept failed\n");
+        return 1;
+    }
+
+    applyOptions(*client, options);
+    ReadBuffer input(*client);
+
+    expectMessage(input, MessageType::AUTHENTICATION_TOKEN);
+    input.read(readInt(input));
+    expectMessage(input, MessageType::PROTOCOL_VERSION);
+    readInt(input);
+
+    send(*client, capture.getData() + session.greeting.begin, session.greeting.end - session.greeting.begin);
+
+    vector<double> latencies;
+    latencies.reserve(session.playerContexts.size());
+
+    for (const Message& message : session.playerContexts) {
+        auto startTime = chrono::steady_clock::now();
+
+        send(*client, capture.getData() + message.begin, message.end - message.begin);
+        expectMessage(input, MessageType::MOVE);
+        input.read(MOVE_MESSAGE_PAYLOAD_SIZE);
+
+        auto elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime);
+        latencies.push_back(elapsed.count() / 1000.0);
+
+        setQuickAck(*client, options);   // Linux resets quick ack mode after delayed ack is sent
+    }
+
+    signed char gameOver = static_cast<signed char>(MessageType::GAME_OVER);
+    send(*client, &gameOver, 1);
+    client->Close();
+
+    printStats(latencies);
+    return 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef _CELL_GRID_H_
+#define _CELL_GRID_H_
+
+#include <memory>
+#include <vector>
+
+#include "TerrainType.h"
+#include "WeatherType.h"
+
+namespace model {
+    // Immutable flat grid of map cells. Cells of one column are contiguous: index is x * height + y
+    template <typename T> class CellGrid {
+    private:
+        int width;
+        int height;
+        std::vector<T> cells;
+    public:
+        CellGrid() : width(0), height(0) { }
+
+        explicit CellGrid(const std::vector<std::vector<T> >& cellsByXY)
+            : width(static_cast<int>(cellsByXY.size())), height(cellsByXY.empty() ? 0 : static_cast<int>(cellsByXY.front().size())) {
+            cells.reserve(static_cast<size_t>(width) * height);
+            for (const std::vector<T>& column : cellsByXY) {
+                cells.insert(cells.end(), column.begin(), column.end());
+            }
+        }
+
+        int getWidth() const {
+            return width;
+        }
+
+        int getHeight() const {
+            return height;
+        }
+
+        bool isEmpty() const {
+            return cells.empty();
+        }
+
+        const T& get(int x, int y) const {
+            return cells[static_cast<size_t>(x) * height + y];
+        }
+    };
+
+    typedef CellGrid<TerrainType> TerrainGrid;
+    typedef CellGrid<WeatherType> WeatherGrid;
+    typedef std::shared_ptr<const TerrainGrid> TerrainGridPtr;
+    typedef std::shared_ptr<const WeatherGrid> WeatherGridPtr;
+}
+
+#endif
@@ -9,6 +9,11 @@ using namespace model;
 Unit::Unit(long long id, double x, double y)
     : id(id), x(x), y(y) { }
 
+void Unit::setPosition(double x, double y) {
+    this->x = x;
+    this->y = y;
+}
+
 long long Unit::getId() const {
     return id;
 }
@@ -11,6 +11,7 @@ namespace model {
         double y;
     protected:
         Unit(long long id, double x, double y);
+        void setPosition(double x, double y);
     public:
         long long getId() const;
         double getX() const;
@@ -36,6 +36,15 @@ Vehicle::Vehicle(const Vehicle& vehicle, const VehicleUpdate& vehicleUpdate)
     remainingAttackCooldownTicks(vehicleUpdate.getRemainingAttackCooldownTicks()), type(vehicle.getType()),
     aerial(vehicle.isAerial()), selected(vehicleUpdate.isSelected()), groups(vehicleUpdate.getGroups()) { }
 
+void Vehicle::update(double x, double y, int durability, int remainingAttackCooldownTicks, bool selected,
+    const vector<int>& groups) {
+    setPosition(x, y);
+    this->durability = durability;
+    this->remainingAttackCooldownTicks = remainingAttackCooldownTicks;
+    this->selected = selected;
+    this->groups = groups;
+}
+
 long long Vehicle::getPlayerId() const {
     return playerId;
 }
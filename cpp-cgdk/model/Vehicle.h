@@ -42,6 +42,9 @@ namespace model {
                 const std::vector<int>& groups);
         Vehicle(const Vehicle& vehicle, const VehicleUpdate& vehicleUpdate);
 
+        void update(double x, double y, int durability, int remainingAttackCooldownTicks, bool selected,
+                    const std::vector<int>& groups);
+
         long long getPlayerId() const;
         int getDurability() const;
         int getMaxDurability() const;
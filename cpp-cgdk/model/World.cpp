@@ -6,13 +6,12 @@ using namespace std;
 World::World()
     : tickIndex(-1), tickCount(-1), width(-1.0), height(-1.0), players(vector<Player>()),
     newVehicles(vector<Vehicle>()), vehicleUpdates(vector<VehicleUpdate>()),
-    terrainByCellXY(vector<vector<TerrainType> >()), weatherByCellXY(vector<vector<WeatherType> >()),
+    terrainByCellXY(make_shared<const TerrainGrid>()), weatherByCellXY(make_shared<const WeatherGrid>()),
     facilities(vector<Facility>()) { }
 
 World::World(int tickIndex, int tickCount, double width, double height, const vector<Player>& players,
     const vector<Vehicle>& newVehicles, const vector<VehicleUpdate>& vehicleUpdates,
-    const vector<vector<TerrainType> >& terrainByCellXY, const vector<vector<WeatherType> >& weatherByCellXY,
-    const vector<Facility>& facilities)
+    const TerrainGridPtr& terrainByCellXY, const WeatherGridPtr& weatherByCellXY, const vector<Facility>& facilities)
     : tickIndex(tickIndex), tickCount(tickCount), width(width), height(height), players(players),
     newVehicles(newVehicles), vehicleUpdates(vehicleUpdates), terrainByCellXY(terrainByCellXY),
     weatherByCellXY(weatherByCellXY), facilities(facilities) { }
@@ -45,11 +44,11 @@ const vector<VehicleUpdate>& World::getVehicleUpdates() const {
     return vehicleUpdates;
 }
 
-const vector<vector<TerrainType> >& World::getTerrainByCellXY() const {
+const TerrainGridPtr& World::getTerrainByCellXY() const {
     return terrainByCellXY;
 }
 
-const vector<vector<WeatherType> >& World::getWeatherByCellXY() const {
+const WeatherGridPtr& World::getWeatherByCellXY() const {
     return weatherByCellXY;
 }
 
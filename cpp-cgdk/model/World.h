@@ -5,6 +5,7 @@
 
 #include <vector>
 
+#include "CellGrid.h"
 #include "Facility.h"
 #include "Player.h"
 #include "TerrainType.h"
@@ -22,15 +23,15 @@ namespace model {
         std::vector<Player> players;
         std::vector<Vehicle> newVehicles;
         std::vector<VehicleUpdate> vehicleUpdates;
-        std::vector<std::vector<TerrainType> > terrainByCellXY;
-        std::vector<std::vector<WeatherType> > weatherByCellXY;
+        TerrainGridPtr terrainByCellXY;
+        WeatherGridPtr weatherByCellXY;
         std::vector<Facility> facilities;
     public:
         World();
         World(int tickIndex, int tickCount, double width, double height, const std::vector<Player>& players,
                 const std::vector<Vehicle>& newVehicles, const std::vector<VehicleUpdate>& vehicleUpdates,
-                const std::vector<std::vector<TerrainType> >& terrainByCellXY,
-                const std::vector<std::vector<WeatherType> >& weatherByCellXY, const std::vector<Facility>& facilities);
+                const TerrainGridPtr& terrainByCellXY, const WeatherGridPtr& weatherByCellXY,
+                const std::vector<Facility>& facilities);
 
         int getTickIndex() const;
         int getTickCount() const;
@@ -39,8 +40,8 @@ namespace model {
         const std::vector<Player>& getPlayers() const;
         const std::vector<Vehicle>& getNewVehicles() const;
         const std::vector<VehicleUpdate>& getVehicleUpdates() const;
-        const std::vector<std::vector<TerrainType> >& getTerrainByCellXY() const;
-        const std::vector<std::vector<WeatherType> >& getWeatherByCellXY() const;
+        const TerrainGridPtr& getTerrainByCellXY() const;
+        const WeatherGridPtr& getWeatherByCellXY() const;
         const std::vector<Facility>& getFacilities() const;
 
         Player getMyPlayer() const;
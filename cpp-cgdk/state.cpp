@@ -23,6 +23,8 @@ void State::updateBeforeMove(const model::World& world, const model::Player& me,
     initState();
 
     m_isMoveCommitted = false;
+    m_pathQueries.clear();
+    m_pathfinder.clearCache();
 
     updateVehicles();
 
@@ -30,72 +32,140 @@ void State::updateBeforeMove(const model::World& world, const model::Player& me,
 
     updateSelection();
 
+    m_controlGroups.update(m_vehicles, world.getTickIndex());
+
     updateNuclearGuide();
 
     updateFacilities();
 
+    updateActionBudget();
+
     updateEnemyStats();
+
+    m_nukePlanner.update(*this, m_changedSlots);
+    m_changedSlots.clear();
+
+    // all groups have dropped this tick's dead by now
+    m_vehicles.releaseDead();
 }
 
 void State::updateAfterMove(const model::World& world, const model::Player& me, const model::Game& game, const model::Move& move)
 {
-    if(move.getAction() != ActionType::NONE && move.getAction() != ActionType::_UNKNOWN_ && move.getAction() != ActionType::TACTICAL_NUCLEAR_STRIKE)
+    if (move.getAction() != ActionType::NONE && move.getAction() != ActionType::_UNKNOWN_)
     {
-        m_lastMoveTick = world.getTickIndex();
+        m_actionBudget.onActionSpent(world.getTickIndex());
+
+        if (move.getAction() != ActionType::TACTICAL_NUCLEAR_STRIKE)
+            m_lastMoveTick = world.getTickIndex();
     }
 }
 
 void State::updateGroups()
 {
     for (auto& group : m_teammates)
-        group.second.update();
+        group.second.applyDeltas();
     updateGroupsRect(m_teammates, m_teammatesRect);
 
     for (auto& group : m_alliens)
-        group.second.update();
+        group.second.applyDeltas();
     updateGroupsRect(m_alliens, m_alliensRect);
 
     for (auto& group : m_newTeammates)
-        group.second.update();
+        group.second.applyDeltas();
+
+    for (auto& group : m_mergingTeammates)
+        group.second.applyDeltas();
 }
 
 void State::updateVehicles()
 {
     for (const model::Vehicle& v : m_world->getNewVehicles())
     {
-        auto newVehicle = std::make_shared<model::Vehicle>(v);
-        m_vehicles[v.getId()] = newVehicle;
-
         bool isTeammate = v.getPlayerId() == m_player->getId();
+        VehicleStore::Slot newVehicle = m_vehicles.add(v, isTeammate);
+        m_vehicleGrid.add(newVehicle);
+        m_vehicleMotion.reset(newVehicle);
+        m_vehicleMotion.record(newVehicle, m_world->getTickIndex(), v);
+        m_changedSlots.push_back(newVehicle);
+
         bool isProduced = isTeammate && m_world->getTickIndex() > 1;
 
         GroupHandle initialGroup = GroupHandle::initial(v);
 
+        VehicleGroup* ownerGroup = nullptr;
+
         if (isProduced)
         {
-            auto existingGroup = m_teammates[initialGroup];
+            const VehicleGroup& existingGroup = m_teammates[initialGroup];
 
-            if (existingGroup.m_rect.contains(v))
-                existingGroup.add(newVehicle);
-            else
-                m_newTeammates[GroupHandle::artificial(v)].add(newVehicle);   // vehicle produced by factory outside its group, put it the the separate list and wait for merge
+            // vehicle produced inside its group isn't added to any group
+            if (!existingGroup.m_rect.contains(v))
+                ownerGroup = &m_newTeammates[GroupHandle::artificial(v)];   // vehicle produced by factory outside its group, put it the the separate list and wait for merge
         }
         else if (isTeammate)
         {
-            m_teammates[initialGroup].add(newVehicle);
+            ownerGroup = &m_teammates[initialGroup];
         }
         else
         {
-            m_alliens[initialGroup].add(newVehicle);
+            ownerGroup = &m_alliens[initialGroup];
         }
+
+        if (ownerGroup == nullptr)
+            continue;
+
+        ownerGroup->add(m_vehicles, newVehicle);
+        m_vehicles.setOwner(newVehicle, ownerGroup);
     }
 
+    // empty when updates are streamed by the decoder
     for (const model::VehicleUpdate& update : m_world->getVehicleUpdates())
     {
-        if (update.getDurability() != 0)
-            vehicleById(update.getId()) = model::Vehicle(vehicleById(update.getId()), update);
-        else
-            m_vehicles.erase(update.getId());
+        applyVehicleUpdate(update.getId(), update.getX(), update.getY(), update.getDurability(), 
+                           update.getRemainingAttackCooldownTicks(), update.isSelected(), update.getGroups());
+    }
+
+    // tick is known only now, the decoder applies updates before
+    for (VehicleStore::Slot slot : m_changedSlots)
+        if (m_vehicles.isAlive(slot))
+            m_vehicleMotion.record(slot, m_world->getTickIndex(), m_vehicles.point(slot));
+}
+
+Point State::predictVehiclePosition(VehicleStore::Slot slot, int ticksAhead) const
+{
+    Point predicted = m_vehicleMotion.predict(slot, m_vehicles.point(slot), m_world->getTickIndex(), ticksAhead);
+
+    predicted.m_x = std::min(std::max(predicted.m_x, 0.0), m_game->getWorldWidth() - 1);
+    predicted.m_y = std::min(std::max(predicted.m_y, 0.0), m_game->getWorldHeight() - 1);
+    return predicted;
+}
+
+void State::applyVehicleUpdate(Id id, double x, double y, int durability, int remainingAttackCooldownTicks,
+                               bool selected, const std::vector<int>& groups)
+{
+    VehicleStore::Slot slot = m_vehicles.findSlot(id);
+    if (slot == VehicleStore::INVALID_SLOT)
+        return;
+
+    VehicleGroup* owner         = m_vehicles.owner(slot);
+    const Point   oldPosition   = m_vehicles.point(slot);
+    const int     oldDurability = m_vehicles.durability(slot);
+
+    m_changedSlots.push_back(slot);
+
+    if (durability != 0)
+    {
+        m_vehicles.update(slot, x, y, durability, remainingAttackCooldownTicks, selected, groups);
+        m_vehicleGrid.move(slot);
+        if (owner)
+            owner->onUnitChanged(slot, oldPosition, oldDurability);
+    }
+    else
+    {
+        m_vehicles.kill(slot);
+        m_vehicleGrid.remove(slot);
+        if (owner)
+            owner->onUnitDied(oldPosition, oldDurability);
     }
 }
 
@@ -176,14 +246,23 @@ void State::updateFacilities()
         m_facilities[f.getId()] = f;
 }
 
+void State::updateActionBudget()
+{
+    int controlCenters = static_cast<int>(std::count_if(m_facilities.begin(), m_facilities.end(), [this](const FacilityById::value_type& f)
+    {
+        return f.second.getType() == FacilityType::CONTROL_CENTER && f.second.getOwnerPlayerId() == m_player->getId();
+    }));
+
+    int allowance = m_game->getBaseActionCount() + controlCenters * m_game->getAdditionalActionCountPerControlCenter();
+    m_actionBudget.update(m_world->getTickIndex(), allowance, !hasActionPoint());
+}
+
 void State::updateNuclearGuide()
 {
     m_nuclearGuideGroup = nullptr;
     if (m_player->getNextNuclearStrikeTickIndex() != -1)
     {
-        Id guideId = m_player->getNextNuclearStrikeVehicleId();
-
-        VehiclePtr guideUnit = m_vehicles[guideId];
+        VehiclePtr guideUnit = nuclearGuideUnit();
 
         if (guideUnit)
             m_nuclearGuideGroup = &teammates(guideUnit->getType());
@@ -195,11 +274,10 @@ void State::updateSelection()
     IdList selection;
     selection.reserve(m_vehicles.size());
 
-    for (const auto& idPointnerPair : m_vehicles)
+    for (VehicleStore::Slot slot = 0; slot < m_vehicles.size(); ++slot)
     {
-        const VehiclePtr& vehicle = idPointnerPair.second;
-        if (vehicle->getPlayerId() == m_player->getId() && vehicle->isSelected())
-            selection.push_back(vehicle->getId());
+        if (m_vehicles.isAlive(slot) && m_vehicles.isMine(slot) && m_vehicles.isSelected(slot))
+            selection.push_back(m_vehicles.id(slot));
     }
 
     std::sort(selection.begin(), selection.end());
@@ -214,7 +292,7 @@ void State::initConstants()
     auto itHelicopter = std::find_if(m_world->getNewVehicles().begin(), m_world->getNewVehicles().end(),
         [](const model::Vehicle& v) { return v.getType() == model::VehicleType::HELICOPTER; });
 
-    const int tileSize = static_cast<int>(m_game->getWorldWidth()) / m_world->getWeatherByCellXY().size();
+    const int tileSize = static_cast<int>(m_game->getWorldWidth()) / m_world->getWeatherByCellXY()->getWidth();
 
     double helicopterRadius = itHelicopter != m_world->getNewVehicles().end() ? itHelicopter->getRadius() : 2;
 
@@ -250,6 +328,24 @@ void State::initConstants()
         },
         m_world->getTerrainByCellXY(), m_world->getWeatherByCellXY()
     );
+
+    const model::TerrainGrid& terrain = *m_world->getTerrainByCellXY();
+    const model::WeatherGrid& weather = *m_world->getWeatherByCellXY();
+
+    std::vector<double> groundMobility;
+    std::vector<double> airMobility;
+    for (int x = 0; x < terrain.getWidth(); ++x)
+    {
+        for (int y = 0; y < terrain.getHeight(); ++y)
+        {
+            groundMobility.push_back(m_constants->getMobilityFactor(terrain.get(x, y)));
+            airMobility.push_back(m_constants->getMobilityFactor(weather.get(x, y)));
+        }
+    }
+
+    m_pathfinder.init(terrain.getWidth(), terrain.getHeight(), tileSize, std::move(groundMobility), std::move(airMobility));
+    m_actionBudget.init(m_game->getActionDetectionInterval());
+    m_controlGroups.init(m_game->getMaxUnitGroup());
 }
 
 void State::initState()
@@ -284,8 +380,31 @@ void State::updateGroupsRect(const GroupByType& groupsMap, Rect& rect)
     }
 }
 
+template <typename Predicate>
+bool State::isSelectionEqual(Predicate isSelectedAfter) const
+{
+    for (VehicleStore::Slot slot = 0; slot < m_vehicles.size(); ++slot)
+    {
+        if (m_vehicles.isAlive(slot) && m_vehicles.isMine(slot) && m_vehicles.isSelected(slot) != isSelectedAfter(slot))
+            return false;
+    }
+
+    return true;
+}
+
+// mirrors the server: a unit is taken by a frame action if its center is inside the frame
+static bool isInFrame(const VehicleStore& vehicles, VehicleStore::Slot slot, const Rect& rect, model::VehicleType vehicleType)
+{
+    return (vehicleType == model::VehicleType::_UNKNOWN_ || vehicles.type(slot) == vehicleType)
+        && vehicles.x(slot) >= rect.m_topLeft.m_x && vehicles.x(slot) <= rect.m_bottomRight.m_x
+        && vehicles.y(slot) >= rect.m_topLeft.m_y && vehicles.y(slot) <= rect.m_bottomRight.m_y;
+}
+
 void State::setSelectAction(const Rect& rect, model::VehicleType vehicleType /*= model::VehicleType::_UNKNOWN_*/)
 {
+    if (isSelectionEqual([this, &rect, vehicleType](VehicleStore::Slot slot) { return isInFrame(m_vehicles, slot, rect, vehicleType); }))
+        return;   // already selected, keep the action point
+
     m_move->setAction(model::ActionType::CLEAR_AND_SELECT);
 
     if (vehicleType != model::VehicleType::_UNKNOWN_)
@@ -301,28 +420,52 @@ void State::setSelectAction(const Rect& rect, model::VehicleType vehicleType /*=
 
 void State::setSelectAction(const VehicleGroup& group)
 {
-    bool isSomethingToSelect = !group.m_units.empty();
+    ControlGroups::Units units;
+    units.reserve(group.m_units.size());
+    std::copy_if(group.m_units.begin(), group.m_units.end(), std::back_inserter(units), [this](VehicleStore::Slot slot) { return m_vehicles.isAlive(slot); });
+    std::sort(units.begin(), units.end());
+
+    if (units.empty())
+        return;   // nothing to select
 
     if (!m_selection.empty())
     {
         IdList desiredSelection;
-        desiredSelection.reserve(group.m_units.size());
+        desiredSelection.reserve(units.size());
 
-        for (const VehicleCache& unitCache : group.m_units)
-            desiredSelection.push_back(unitCache.lock()->getId());
+        for (VehicleStore::Slot slot : units)
+            desiredSelection.push_back(m_vehicles.id(slot));
 
         std::sort(desiredSelection.begin(), desiredSelection.end());
 
         if (desiredSelection == m_selection)
-            isSomethingToSelect = false;  // already selected
+        {
+            m_controlGroups.setCandidate(std::move(units));
+            return;   // already selected
+        }
     }
 
-    if (isSomethingToSelect)
-        setSelectAction(group.m_rect, group.m_units.front().lock()->getType());
+    // a control group selects exactly the units, a frame may catch strays
+    int number = m_controlGroups.find(units);
+    if (number)
+        setSelectAction(number);
+    else
+        setSelectAction(group.m_rect, group.front().getType());
+
+    m_controlGroups.setCandidate(std::move(units));
 }
 
 void State::setSelectAction(int groupId)
 {
+    auto isInGroup = [this, groupId](VehicleStore::Slot slot)
+    {
+        const std::vector<int>& groups = m_vehicles.vehicle(slot).getGroups();
+        return std::find(groups.begin(), groups.end(), groupId) != groups.end();
+    };
+
+    if (isSelectionEqual(isInGroup))
+        return;
+
     m_move->setAction(model::ActionType::CLEAR_AND_SELECT);
     m_move->setGroup(groupId);
 
@@ -331,6 +474,9 @@ void State::setSelectAction(int groupId)
 
 void State::setAddSelectionAction(const Rect& rect, model::VehicleType vehicleType /*= model::VehicleType::_UNKNOWN_*/)
 {
+    if (isSelectionEqual([this, &rect, vehicleType](VehicleStore::Slot slot) { return m_vehicles.isSelected(slot) || isInFrame(m_vehicles, slot, rect, vehicleType); }))
+        return;   // nothing new to add
+
     m_move->setAction(model::ActionType::ADD_TO_SELECTION);
 
     if (vehicleType != model::VehicleType::_UNKNOWN_)
@@ -346,6 +492,9 @@ void State::setAddSelectionAction(const Rect& rect, model::VehicleType vehicleTy
 
 void State::setDeselectAction(const Rect& rect, model::VehicleType vehicleType /*= model::VehicleType::_UNKNOWN_*/)
 {
+    if (isSelectionEqual([this, &rect, vehicleType](VehicleStore::Slot slot) { return m_vehicles.isSelected(slot) && !isInFrame(m_vehicles, slot, rect, vehicleType); }))
+        return;   // nothing to deselect
+
     m_move->setAction(model::ActionType::DESELECT);
 
     if (vehicleType != model::VehicleType::_UNKNOWN_)
@@ -367,6 +516,41 @@ void State::setAssignGroupAction(int groupNumber)
     m_isMoveCommitted = true;
 }
 
+void State::setDisbandAction(int groupNumber)
+{
+    m_move->setAction(model::ActionType::DISBAND);
+    m_move->setGroup(groupNumber);
+
+    m_isMoveCommitted = true;
+}
+
+void State::maintainControlGroups()
+{
+    if (!m_controlGroups.isInitialized())
+        return;
+
+    if (int stale = m_controlGroups.findStale())
+    {
+        setDisbandAction(stale);
+        m_controlGroups.onDisbanded(stale);
+        return;
+    }
+
+    const ControlGroups::Units& candidate = m_controlGroups.candidate();
+    if (candidate.empty() || m_controlGroups.find(candidate))
+        return;   // nothing to bind or already bound
+
+    bool isCandidateSelected = isSelectionEqual([&candidate](VehicleStore::Slot slot) { return std::binary_search(candidate.begin(), candidate.end(), slot); });
+    if (!isCandidateSelected)
+        return;
+
+    if (int number = m_controlGroups.numberForCandidate())
+    {
+        setAssignGroupAction(number);
+        m_controlGroups.onAssigned(number);
+    }
+}
+
 void State::setMoveAction(const Vec2d& vector, double maxSpeed /*= -1*/)
 {
     m_move->setAction(model::ActionType::MOVE);
@@ -417,22 +601,22 @@ State::Constants::PointInt State::Constants::getTileIndex(const Point& p) const
 
 model::WeatherType State::Constants::getWeather(const PointInt& tile) const
 {
-    bool isValidRange = tile.m_x < (int)m_weather.size() && tile.m_y < (int)m_weather.front().size();
+    bool isValidRange = tile.m_x < m_weather->getWidth() && tile.m_y < m_weather->getHeight();
     assert(isValidRange);
     if (!isValidRange)
         return WeatherType::CLEAR;
 
-    return m_weather[tile.m_x][tile.m_y];
+    return m_weather->get(tile.m_x, tile.m_y);
 }
 
 model::TerrainType State::Constants::getTerrain(const PointInt& tile) const
 {
-    bool isValidRange = tile.m_x < (int)m_terrain.size() && tile.m_y < (int)m_terrain.front().size();
+    bool isValidRange = tile.m_x < m_terrain->getWidth() && tile.m_y < m_terrain->getHeight();
     assert(isValidRange);
     if (!isValidRange)
         return TerrainType::PLAIN;
 
-    return m_terrain[tile.m_x][tile.m_y];
+    return m_terrain->get(tile.m_x, tile.m_y);
 }
 
 double State::Constants::getMaxVisionRange(model::VehicleType type) const
@@ -486,25 +670,38 @@ size_t State::newTeammatesCount() const
         [](int old, const auto& idGroupPair) { return old += idGroupPair.second.m_units.size(); });
 }
 
-State::GroupByType State::popNewUnits()
+const State::GroupByType& State::popNewUnits()
 {
-    GroupByType newPortion;
-    std::swap(newPortion, m_newTeammates);
-    return newPortion;
+    // swapping maps doesn't move the groups, so owners of the units stay valid
+    std::swap(m_mergingTeammates, m_newTeammates);
+    return m_mergingTeammates;
 }
 
-void State::mergeNewUnits(const std::pair<GroupHandle, VehicleGroup>& newUnits)
+void State::mergeNewUnits()
 {
-    m_teammates.insert(newUnits);
+    for (const auto& handleGroupPair : m_mergingTeammates)
+    {
+        // a portion becomes the initial group only if there is none yet, units for an existing group are dropped
+        auto inserted = m_teammates.insert(std::make_pair(GroupHandle::initial(handleGroupPair.first.vehicleType()), handleGroupPair.second));
+        VehicleGroup* mergeTo = inserted.second ? &inserted.first->second : nullptr;
+
+        for (VehicleStore::Slot slot : handleGroupPair.second.m_units)
+        {
+            if (m_vehicles.isAlive(slot))
+                m_vehicles.setOwner(slot, mergeTo);
+        }
+    }
+
+    m_mergingTeammates.clear();
+    m_pathQueries.clear();
+
     updateGroups();
 }
 
 VehiclePtr State::nuclearGuideUnit() const
 {
-    Id guideId = m_player->getNextNuclearStrikeVehicleId();
-
-    auto found = m_vehicles.find(guideId);
-    return found != m_vehicles.end() ? found->second : nullptr;
+    VehicleStore::Slot slot = m_vehicles.findSlot(m_player->getNextNuclearStrikeVehicleId());
+    return slot != VehicleStore::INVALID_SLOT ? &m_vehicles.vehicle(slot) : nullptr;
 }
 
 double State::getUnitVisionRangeAt(const model::Vehicle& v, const Point& pos) const
@@ -541,6 +738,7 @@ bool State::isEnemyCoveredByAnother(model::VehicleType groupId, VehicleGroup& me
         {
             // merge
             isCovered = true;
+            mergedGroups.m_store = other->m_store;
             std::copy(other->m_units.begin(), other->m_units.end(), std::inserter(mergedGroups.m_units, mergedGroups.m_units.end()));
         }
     }
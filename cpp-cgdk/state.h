@@ -19,15 +19,24 @@
 
 #include "geometry.h"
 #include "VehicleGroup.h"
-
-class State
+#include "VehicleStore.h"
+#include "VehicleGrid.h"
+#include "VehicleMotion.h"
+#include "NukePlanner.h"
+#include "PathQueryCache.h"
+#include "GroupPathfinder.h"
+#include "ActionBudget.h"
+#include "ControlGroups.h"
+#include "VehicleUpdateSink.h"
+
+class State : public VehicleUpdateSink
 {
 public:
     typedef decltype(((model::Vehicle*)nullptr)->getId()) Id;
     static const Id INVALID_ID = (Id)-1;
 
     typedef std::unordered_map<Id, model::Facility>       FacilityById;
-    typedef std::unordered_map<Id, VehiclePtr>            VehicleByID;
+    typedef VehicleStore                                  VehicleByID;
     typedef std::map<GroupHandle, VehicleGroup>           GroupByType;    // not eligible for unordered_map due to references to VehicleGroup's
     typedef std::vector<Id>                               IdList;
 
@@ -48,11 +57,20 @@ public:
 private:
 
     VehicleByID   m_vehicles;
+    VehicleGrid   m_vehicleGrid;
+    VehicleMotion m_vehicleMotion;
+    std::vector<VehicleStore::Slot> m_changedSlots; // updated, added or killed since last tick
+    NukePlanner   m_nukePlanner;
+    mutable PathQueryCache m_pathQueries;   // valid within a tick
+    mutable GroupPathfinder m_pathfinder;
     FacilityById  m_facilities;
     IdList        m_selection;
+    ActionBudget  m_actionBudget;
+    ControlGroups m_controlGroups;
     GroupByType   m_alliens;
     GroupByType   m_teammates;
     GroupByType   m_newTeammates;         // TODO: group by facility ID?
+    GroupByType   m_mergingTeammates;     // popped new units on their way to the initial groups
     bool          m_isMoveCommitted;
     int           m_lastMoveTick;
 
@@ -87,8 +105,8 @@ private:
         typedef std::map<model::WeatherType, double> AirMobility;
         typedef std::map<model::VehicleType, double> UnitVisionRadius;
 
-        typedef std::remove_reference_t<decltype(static_cast<model::World*>(nullptr)->getTerrainByCellXY())> TerrainCells;
-        typedef std::remove_reference_t<decltype(static_cast<model::World*>(nullptr)->getWeatherByCellXY())> WeatherCells;
+        typedef model::TerrainGridPtr TerrainCells;
+        typedef model::WeatherGridPtr WeatherCells;
 
         double           m_helicoprerRadius;
         GroundVisibility m_groundVisibility;
@@ -132,6 +150,11 @@ private:
     void updateEnemyStats();
     void updateFacilities();
     void updateGroups();
+    void updateActionBudget();
+
+    // true if the units matching the predicate are exactly the selected ones, i.e. a select action is redundant
+    template <typename Predicate>
+    bool isSelectionEqual(Predicate isSelectedAfter) const;
 
 public:
 
@@ -142,17 +165,37 @@ public:
         GROUP_CAPTURING,
     };
 
-    State() : m_world(nullptr), m_game(nullptr), m_move(nullptr), m_player(nullptr), m_enemy(nullptr)
+    State() : m_vehicleGrid(m_vehicles), m_world(nullptr), m_game(nullptr), m_move(nullptr), m_player(nullptr), m_enemy(nullptr)
             , m_isMoveCommitted(false), m_nuclearGuideGroup(nullptr), m_lastMoveTick(-1)
     {}
 
     Constants& constants() { return *m_constants; }
 
-    bool                  hasVehicleById(Id id) const { return m_vehicles.find(id) != m_vehicles.end(); }
-    const model::Vehicle& vehicleById(Id id)    const { return *m_vehicles.find(id)->second; }
-    model::Vehicle&       vehicleById(Id id)          { return *m_vehicles.find(id)->second; }
+    bool                  hasVehicleById(Id id) const { return m_vehicles.findSlot(id) != VehicleStore::INVALID_SLOT; }
+    const model::Vehicle& vehicleById(Id id)    const { return m_vehicles.vehicle(m_vehicles.findSlot(id)); }
 
     const VehicleByID&    getAllVehicles() const      { return m_vehicles; }
+    const VehicleGrid&    vehicleGrid() const         { return m_vehicleGrid; }
+
+    const NukePlanner&    nukePlanner() const         { return m_nukePlanner; }
+
+    // memoized mover.isPathFree(to, obstacle), see PathQueryCache
+    template <typename Mover, typename Obstacle>
+    bool isPathFree(const Mover& mover, const Point& to, const Obstacle& obstacle) const  { return m_pathQueries.isPathFree(mover, to, obstacle); }
+
+    // path of a group around obstacle rects over terrain/weather tiles, see GroupPathfinder
+    bool findGroupPath(model::VehicleType type, const Rect& groupRect, const Point& destination, const std::vector<Rect>& obstacles, std::vector<Point>& path) const
+    {
+        return m_pathfinder.findPath(type, groupRect, destination, obstacles, path);
+    }
+
+    // extrapolated by recent velocity and clamped to the world
+    Point predictVehiclePosition(VehicleStore::Slot slot, int ticksAhead) const;
+
+    // called by decoder while reading a world, i.e. before updateBeforeMove(). New vehicles arrive later in World, 
+    // but this is fine: server never sends an update for a vehicle in the same tick it's reported as new
+    void applyVehicleUpdate(Id id, double x, double y, int durability, int remainingAttackCooldownTicks,
+                            bool selected, const std::vector<int>& groups) override;
 
     const model::World*  world()    const { return m_world; };
     const model::Player* player()   const { return m_player; };
@@ -171,9 +214,13 @@ public:
     const GroupByType&  alliens() const                          { return m_alliens; }
     size_t  newTeammatesCount() const;
 
-    GroupByType popNewUnits();
+    // new units are kept here until merged, so that they are updated as other groups and their slots aren't recycled under them.
+    // Units produced after the pop wait for the next one
+    const GroupByType& popNewUnits();
+    const GroupByType& mergingUnits() const                      { return m_mergingTeammates; }
 
-    void mergeNewUnits(const std::pair<GroupHandle, VehicleGroup>& newUnits);
+    // popped units become the initial groups of their types where those don't exist, others are left without a group
+    void mergeNewUnits();
 
     const VehicleGroup* nuclearGuideGroup() const                { return m_nuclearGuideGroup; }
     Point nuclearMissileTarget() const                           { return m_nuclearGuideGroup ? Point(m_player->getNextNuclearStrikeX(), m_player->getNextNuclearStrikeY()) : Point(); }
@@ -188,6 +235,7 @@ public:
     int  lastMoveTick() const                                    { return m_lastMoveTick; }
     bool isMoveCommitted() const                                 { return m_isMoveCommitted; }
     bool hasActionPoint() const                                  { return player()->getRemainingActionCooldownTicks() == 0; }
+    const ActionBudget& actionBudget() const                     { return m_actionBudget; }
     bool isCorrectPosition(const Point& p) const                 { return p.m_x >= 0 && p.m_y >= 0 && p.m_x <= m_game->getWorldWidth() && p.m_y <= m_game->getWorldHeight();}
     bool isCorrectPosition(const Rect& r) const                  { return isCorrectPosition(r.m_topLeft) && isCorrectPosition(r.m_bottomRight); }
 
@@ -207,6 +255,9 @@ public:
 
     static void updateGroupsRect(const GroupByType& groupsMap, Rect& rect);
 
+    // spends a spare action on control groups: disbands a stale one or binds the selected group to a number
+    void maintainControlGroups();
+
 
     // actions
 
@@ -216,6 +267,7 @@ public:
     void setSelectAction(int groupId);
     void setDeselectAction(const Rect& rect, model::VehicleType vehicleType = model::VehicleType::_UNKNOWN_);
     void setAssignGroupAction(int groupNumber);
+    void setDisbandAction(int groupNumber);
 
     void setMoveAction(const Vec2d& vector, double maxSpeed = -1);
     void setNukeAction(const Point& point, const model::Vehicle& guide);